@@ -0,0 +1,126 @@
+/**
+ * Arena.cpp - This is an implementation of the Arena class
+ */
+
+#include "Arena.h"
+
+#include <cstdint>
+#include <new>
+
+/* 
+ * This is a constructor for an empty Arena. No memory is reserved until the first
+ * allocation.
+ * 
+ * Parameters:
+ *  blockSize - bytes requested from the heap at a time
+ */
+Arena::Arena(std::size_t blockSize)
+:blockSize(blockSize), reserved(0), next(NULL), end(NULL), stats()
+{}
+
+/* 
+ * This is a destructor for an Arena. All memory handed out is freed, without running
+ * any destructors.
+ * 
+ * Parameters:
+ * 	none
+ */
+Arena::~Arena(){
+    release();
+}
+
+/* 
+ * Carves memory out of the arena. The memory stays valid until release is called or the
+ * arena is destroyed. Requests larger than a block get a block of their own.
+ * 
+ * Parameters:
+ *  size - number of bytes needed
+ *  alignment - required alignment, must be a power of two
+ * 
+ * Returns:
+ *  pointer to the memory
+ */
+void* Arena::allocate(std::size_t size, std::size_t alignment){
+    std::uintptr_t address = reinterpret_cast<std::uintptr_t>(next);
+    std::size_t padding = (alignment - address % alignment) % alignment;
+
+    if(next == NULL || padding + size > static_cast<std::size_t>(end - next)){
+        // ::operator new is aligned for max_align_t, so a fresh block needs no padding
+        // unless the alignment is stricter than that
+        std::size_t needed = size + (alignment > alignof(std::max_align_t) ? alignment : 0);
+        char* block = static_cast<char*>(::operator new(needed > blockSize ? needed : blockSize));
+
+        blocks.push_back(block);
+        stats.blocks++;
+
+        if(needed > blockSize){
+            // oversized, so keep carving from the current block afterwards
+            reserved += needed;
+            address = reinterpret_cast<std::uintptr_t>(block);
+            padding = (alignment - address % alignment) % alignment;
+            stats.allocations++;
+            stats.bytes += padding + size;
+            return block + padding;
+        }
+
+        reserved += blockSize;
+        next = block;
+        end = block + blockSize;
+        address = reinterpret_cast<std::uintptr_t>(next);
+        padding = (alignment - address % alignment) % alignment;
+    }
+
+    char* memory = next + padding;
+    next = memory + size;
+
+    stats.allocations++;
+    stats.bytes += padding + size;
+    return memory;
+}
+
+/* 
+ * Frees every block at once. Objects placed in the arena must already have been
+ * destroyed if their destructors matter.
+ * 
+ * Parameters:
+ * 	none
+ * 
+ * Returns:
+ *   void
+ */
+void Arena::release(){
+    for(std::vector<char*>::const_iterator iter(blocks.begin()); iter != blocks.end(); ++iter){
+        ::operator delete(*iter);
+    }
+
+    blocks.clear();
+    reserved = 0;
+    next = NULL;
+    end = NULL;
+}
+
+/* 
+ * Returns the allocation counters of the arena.
+ * 
+ * Parameters:
+ * 	none
+ * 
+ * Returns:
+ *  reference to the counters
+ */
+const Arena::Stats& Arena::getStats() const{
+    return stats;
+}
+
+/* 
+ * Returns the number of bytes currently reserved from the heap.
+ * 
+ * Parameters:
+ * 	none
+ * 
+ * Returns:
+ *  bytes reserved
+ */
+std::size_t Arena::getReserved() const{
+    return reserved;
+}
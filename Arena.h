@@ -0,0 +1,119 @@
+/**
+ * Arena.h - Interface for the Arena class, a monotonic allocator that
+ *           hands out memory from large blocks and frees it all at once.
+ */
+
+#ifndef _ARENA_H
+#define _ARENA_H
+
+#include <cstddef>
+#include <vector>
+
+class Arena{
+
+    public:
+        /* 
+        * Counters describing the traffic an arena has seen. They are cumulative, so they keep
+        * counting across calls to release.
+        */
+        struct Stats{
+            // requests carved out of the arena
+            unsigned long allocations;
+            // blocks requested from the heap
+            unsigned long blocks;
+            // bytes handed out by allocate, including alignment padding
+            unsigned long bytes;
+        };
+
+        /* 
+        * This is a constructor for an empty Arena. No memory is reserved until the first
+        * allocation.
+        * 
+        * Parameters:
+        *  blockSize - bytes requested from the heap at a time
+        */
+        Arena(std::size_t blockSize = 64 * 1024);
+
+        /* 
+        * This is a destructor for an Arena. All memory handed out is freed, without running
+        * any destructors.
+        * 
+        * Parameters:
+        * 	none
+        */
+        ~Arena();
+
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        /* 
+        * Carves memory out of the arena. The memory stays valid until release is called or the
+        * arena is destroyed. Requests larger than a block get a block of their own.
+        * 
+        * Parameters:
+        *  size - number of bytes needed
+        *  alignment - required alignment, must be a power of two
+        * 
+        * Returns:
+        *  pointer to the memory
+        */
+        void* allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t));
+
+        /* 
+        * Frees every block at once. Objects placed in the arena must already have been
+        * destroyed if their destructors matter.
+        * 
+        * Parameters:
+        * 	none
+        * 
+        * Returns:
+        *   void
+        */
+        void release();
+
+        /* 
+        * Returns the allocation counters of the arena.
+        * 
+        * Parameters:
+        * 	none
+        * 
+        * Returns:
+        *  reference to the counters
+        */
+        const Stats& getStats() const;
+
+        /* 
+        * Returns the number of bytes currently reserved from the heap.
+        * 
+        * Parameters:
+        * 	none
+        * 
+        * Returns:
+        *  bytes reserved
+        */
+        std::size_t getReserved() const;
+
+    private:
+        std::size_t blockSize;
+        std::size_t reserved;
+        std::vector<char*> blocks;
+
+        // free space left in the current block
+        char* next;
+        char* end;
+
+        Stats stats;
+};
+
+/* 
+ * Placement forms of new and delete for constructing objects in an arena, as in
+ * 'new (arena) Color(color)'. The delete form is only called when a constructor throws, and
+ * does nothing since arena memory is freed in bulk.
+ */
+inline void* operator new(std::size_t size, Arena& arena){
+    return arena.allocate(size);
+}
+
+inline void operator delete(void*, Arena&){}
+
+#endif
@@ -7,13 +7,74 @@
  */
 
 #include "Image.h"
+#include "Line.h"
+#include "Triangle.h"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+
+// Binary scene format, all integers little-endian:
+//   offset  0  magic, the 8 bytes of BINARY_MAGIC
+//   offset  8  u32 version
+//   offset 12  u32 size of the header in bytes, where the first array starts
+//   offset 16  u64 number of shapes
+//   offset 24  u64 number of (x, y) vertex pairs
+// followed by the arrays, one entry per shape except for the verticies and each padded with
+// zeros to a multiple of 8 bytes: u8 kinds, u8 flags, u32 colors, u32 vertex offsets, and the
+// f64 (x, y) verticies.
+static const char BINARY_MAGIC[8] = {'S', 'H', 'A', 'P', 'E', 'B', 'I', 'N'};
+static const uint32_t BINARY_VERSION = 1;
+static const uint32_t BINARY_HEADER_SIZE = 32;
+static const uint64_t BINARY_ALIGNMENT = 8;
+
+// where the version, header size, shape count and vertex count are in the header, and their sizes
+static const unsigned int HEADER_FIELDS = 4;
+static const unsigned int HEADER_FIELD_OFFSETS[HEADER_FIELDS] = {8, 12, 16, 24};
+static const unsigned int HEADER_FIELD_SIZES[HEADER_FIELDS] = {4, 4, 8, 8};
+
+// colors and vertex offsets are written as they are kept, so they have to be the sizes above
+static_assert(sizeof(unsigned int) == 4 && sizeof(double) == 8, "unexpected type sizes");
+
+// smallest part of a text image file worth parsing on a thread of its own
+static const std::size_t TEXT_CHUNK_SIZE = 1 << 20;
+
+static bool isLittleEndian();
+static uint64_t padded(uint64_t size);
+static uint64_t arraysSize(uint64_t shapeCount, uint64_t vertexCount);
+static void writeHeader(unsigned char* header, uint64_t shapeCount, uint64_t vertexCount);
+static bool readHeader(const unsigned char* header, uint32_t& headerSize, uint64_t& shapeCount,
+                       uint64_t& vertexCount);
+static bool validShapes(const ShapeKind* kinds, const unsigned int* vertexOffsets, uint64_t shapeCount,
+                        uint64_t vertexCount);
+static void writeArray(std::ostream& os, const void* data, uint64_t count, unsigned int size);
+static bool nextLine(std::string_view text, std::size_t& position, std::string_view& line);
+static int parseInt(std::string_view field);
+static void parseVertex(std::string_view line, double* vertex);
+static bool parseRecord(std::string_view text, std::size_t& position, unsigned int count,
+                        std::string_view end, double* verticies, unsigned int& color, bool& filled);
+static bool parseShapes(std::string_view text, std::size_t& position, Image* image,
+                        std::size_t limit = std::string_view::npos);
+static std::size_t recordStart(std::string_view text, std::size_t from);
+static bool readArray(std::istream& is, void* data, uint64_t count, unsigned int size);
 
 /* This is default constructor for creating an Image object.
  * 
  * Parameters:
- *      none
+ *      storage - how shapes are stored, defaults to SHAPES
  */
-Image::Image(){}
+Image::Image(Storage storage)
+:storage(storage), visibleGeneration(0), drawnGeneration(0), damaged(false)
+{
+    useVectors();
+}
 
 /* This is a copy constructor for the image class. This will create deep copies of all
  * shapes in the image class
@@ -21,14 +82,11 @@ Image::Image(){}
  * Parameters:
  * 	im - reference to an image object.
  */
-Image::Image(const Image& im){
-    std::vector<Shape*> temp;
-
-    for(std::vector<Shape*>::const_iterator iter(im.shapes.begin()); iter != im.shapes.end(); ++iter){
-        temp.push_back(&(*iter)->clone());
-    }
-
-    shapes = temp;
+Image::Image(const Image& im)
+:storage(im.storage), visibleGeneration(0), drawnGeneration(0), damaged(false)
+{
+    useVectors();
+    *this = im;
 }
 
 /* This is a destructor for an Image object. This will call destructors for all
@@ -52,12 +110,26 @@ Image::~Image(){
  *  a reference to an Image.
  */
 Image& Image::operator=(const Image& im){
-    for(std::vector<Shape*>::const_iterator iter(shapes.begin()); iter != shapes.end(); ++iter){
-        delete *iter;
-    }
+    if(this == &im) return *this;
 
-    for(std::vector<Shape*>::const_iterator iter(im.shapes.begin()); iter != im.shapes.end(); ++iter){
-        shapes.push_back(&(*iter)->clone());
+    erase();
+
+    storage = im.storage;
+    if(storage == Storage::SHAPES){
+        for(std::vector<Shape*>::const_iterator iter(im.shapes.begin()); iter != im.shapes.end(); ++iter){
+            append(&(*iter)->clone(arena));
+        }
+    }else{
+        // im may be mapped, so its arrays are copied rather than its vectors
+        const Arrays& from = im.arrays;
+        kinds.assign(from.kinds, from.kinds + from.shapeCount);
+        colors.assign(from.colors, from.colors + from.shapeCount);
+        flags.assign(from.flags, from.flags + from.shapeCount);
+        vertexOffsets.assign(from.vertexOffsets, from.vertexOffsets + from.shapeCount);
+        modelVerticies.assign(from.verticies, from.verticies + 2 * from.pointCount);
+        useVectors();
+        index = im.index;
+        deviceGenerations.assign(from.shapeCount, 0);
     }
 
     return *this;
@@ -73,22 +145,264 @@ Image& Image::operator=(const Image& im){
  *   void
  */
 void Image::add(Shape * shape){
-    shapes.push_back(&shape->clone());
+    if(storage == Storage::SHAPES){
+        append(&shape->clone(arena));
+    }else{
+        double packed[6];
+        shape->packVerticies(packed);
+        appendPacked(shape->getKind(), shape->getColor(), packed, shape->getFlags());
+    }
 }
 
 /* 
- * This method will iterate through the Image container and draw each image.
+ * Adds a shape given as packed verticies to the Image container. In SHAPES storage a
+ * Shape object is created for it.
+ * 
+ * Parameters:
+ * 	kind - kind of shape
+ *  color - color of the shape
+ *  verticies - getVertexCount(kind) packed (x, y) pairs in model coordinates
+ *  flags - combination of SHAPE_ flags, as returned by Shape::getFlags
+ * 
+ * Returns
+ *   void
+ */
+void Image::add(ShapeKind kind, unsigned int color, const double* verticies, unsigned char flags){
+    appendPacked(kind, color, verticies, flags);
+    if(storage == Storage::SHAPES){
+        shapes.push_back(placeShape(arrays.shapeCount - 1));
+    }
+}
+
+/* 
+ * This method will draw every shape in the Image container that can be seen in the window,
+ * then flush the graphics context. Shapes are drawn in the order they were added.
  * 
  * Parameters:
  * 	gc - pointer to a graphics context object.
+ *  vc - pointer to the view context used to convert to device coordinates.
  * 
  * Returns: 
  *  void
  */
 void Image::draw(GraphicsContext* gc, ViewContext* vc){
     gc->clear();
-    for(std::vector<Shape*>::const_iterator iter(shapes.begin()); iter != shapes.end(); ++iter){
-        (*iter)->draw(gc, vc);
+
+    unsigned long generation = vc->getGeneration();
+    int width = gc->getWindowWidth();
+    int height = gc->getWindowHeight();
+
+    if(visibleGeneration != generation || visibleWidth != width || visibleHeight != height){
+        GraphicsContext::Rect window = {0, 0, width, height};
+        updateIndex();
+        index.query(toModelArea(vc, window), visible);
+
+        visibleGeneration = generation;
+        visibleWidth = width;
+        visibleHeight = height;
+    }
+
+    transformShapes(vc, visible);
+    rasterizeShapes(gc, visible);
+
+    // the whole window now shows this view
+    drawnGeneration = generation;
+    drawnWidth = width;
+    drawnHeight = height;
+    damaged = false;
+
+    // the end of a frame, so make sure nothing is left queued in the context
+    gc->flush();
+}
+
+/* 
+ * This method will bring the window up to date after shapes were added, redrawing only the
+ * area the new shapes cover. That area is cleared, and every shape reaching into it is drawn
+ * again in order, clipped to it. Falls back on a full draw when the view or the window size
+ * changed since the last draw, or the image was erased.
+ * 
+ * Parameters:
+ * 	gc - pointer to a graphics context object.
+ *  vc - pointer to the view context used to convert to device coordinates.
+ * 
+ * Returns: 
+ *  void
+ */
+void Image::drawDirty(GraphicsContext* gc, ViewContext* vc){
+    int width = gc->getWindowWidth();
+    int height = gc->getWindowHeight();
+
+    if(drawnGeneration != vc->getGeneration() || drawnWidth != width || drawnHeight != height){
+        draw(gc, vc);
+        return;
+    }
+
+    if(damaged){
+        damaged = false;
+
+        // The damage in device coordinates, grown by a pixel for truncation and cut down to
+        // the window before converting to int.
+        PointBlock<4> corners;
+        corners[0] = Vec4(damage.minX, damage.minY);
+        corners[1] = Vec4(damage.maxX, damage.minY);
+        corners[2] = Vec4(damage.minX, damage.maxY);
+        corners[3] = Vec4(damage.maxX, damage.maxY);
+        corners = vc->modelToDevice(corners);
+
+        double left = corners[0].x, top = corners[0].y, right = corners[0].x, bottom = corners[0].y;
+        for(unsigned int i = 1; i < 4; i++){
+            left = std::min(left, corners[i].x);
+            top = std::min(top, corners[i].y);
+            right = std::max(right, corners[i].x);
+            bottom = std::max(bottom, corners[i].y);
+        }
+        left = std::max(std::floor(left) - 1, 0.0);
+        top = std::max(std::floor(top) - 1, 0.0);
+        right = std::min(std::ceil(right) + 2, (double)width);
+        bottom = std::min(std::ceil(bottom) + 2, (double)height);
+
+        if(left < right && top < bottom){
+            GraphicsContext::Rect area = {(int)left, (int)top, (int)(right - left), (int)(bottom - top)};
+            redrawArea(gc, vc, area);
+        }
+    }
+
+    gc->flush();
+}
+
+/* 
+ * This method will redraw an area of the window whose contents were lost, such as one that was
+ * just uncovered. The area is cleared and every shape reaching into it is drawn again in order,
+ * clipped to it. Falls back on a full draw when the rest of the window does not show the
+ * current view.
+ * 
+ * Parameters:
+ * 	gc - pointer to a graphics context object.
+ *  vc - pointer to the view context used to convert to device coordinates.
+ *  area - area of the window to redraw
+ * 
+ * Returns: 
+ *  void
+ */
+void Image::drawArea(GraphicsContext* gc, ViewContext* vc, const GraphicsContext::Rect& area){
+    if(drawnGeneration != vc->getGeneration() ||
+       drawnWidth != gc->getWindowWidth() || drawnHeight != gc->getWindowHeight()){
+        draw(gc, vc);
+        return;
+    }
+
+    if(area.width > 0 && area.height > 0){
+        redrawArea(gc, vc, area);
+    }
+
+    gc->flush();
+}
+
+/* 
+ * Returns the model coordinates of every shape's verticies as one packed buffer of (x, y)
+ * pairs, in the order the shapes were added.
+ * 
+ * Parameters:
+ * 	none
+ * 
+ * Returns:
+ *  reference to the packed verticies
+ */
+const double* Image::getVerticies() const{
+    return arrays.verticies;
+}
+
+/* 
+ * Returns the number of (x, y) pairs returned by getVerticies.
+ * 
+ * Parameters:
+ * 	none
+ * 
+ * Returns:
+ *  number of verticies
+ */
+unsigned int Image::getPointCount() const{
+    return arrays.pointCount;
+}
+
+/* 
+ * Returns the number of shapes in the Image container.
+ * 
+ * Parameters:
+ * 	none
+ * 
+ * Returns:
+ *  number of shapes
+ */
+unsigned int Image::size() const{
+    return arrays.shapeCount;
+}
+
+/* 
+ * Returns a copy of a shape in the Image container. A copy is returned to prevent
+ * manipulation of the image, and so that PACKED images can provide one as well.
+ * 
+ * Parameters:
+ * 	index - position of the shape, in the order shapes were added
+ * 
+ * Returns:
+ *  pointer to a new shape object, which the caller must delete
+ */
+Shape* Image::getShape(unsigned int index) const{
+    if(storage == Storage::SHAPES) return &shapes.at(index)->clone();
+    return makeShape(index);
+}
+
+/* 
+ * Returns how the Image container stores its shapes.
+ * 
+ * Parameters:
+ * 	none
+ * 
+ * Returns:
+ *  storage of the image
+ */
+Image::Storage Image::getStorage() const{
+    return storage;
+}
+
+/* 
+ * Returns the allocation counters of the arena holding the shapes of a SHAPES image. They
+ * count every shape, color and vertex block placed in the arena since the image was created.
+ * 
+ * Parameters:
+ * 	none
+ * 
+ * Returns:
+ *  reference to the counters
+ */
+const Arena::Stats& Image::getAllocationStats() const{
+    return arena.getStats();
+}
+
+/* 
+ * Prints a shape stored as packed verticies with Line::write or Triangle::write, which Line::out
+ * and Triangle::out also print with.
+ * 
+ * Parameters:
+ * 	writer - reference to the writer
+ *  kind - kind of shape
+ *  color - color of the shape
+ *  verticies - getVertexCount(kind) packed (x, y) pairs in model coordinates
+ *  flags - combination of SHAPE_ flags
+ * 
+ * Returns:
+ *  void
+ */
+static void writeShape(TextWriter& writer, ShapeKind kind, unsigned int color, const double* verticies,
+                       unsigned char flags){
+    switch(kind){
+        case ShapeKind::LINE:
+            Line::write(writer, verticies, color);
+            break;
+        case ShapeKind::TRIANGLE:
+            Triangle::write(writer, verticies, color, flags & SHAPE_FILLED);
+            break;
     }
 }
 
@@ -102,13 +416,22 @@ void Image::draw(GraphicsContext* gc, ViewContext* vc){
  *  output stream being passed in
  */
 std::ostream& Image::out(std::ostream& os){
-    os << "Begin Image" << std::endl;
-    os << "Begin Shapes" << std::endl;
-    for(std::vector<Shape*>::const_iterator iter(shapes.begin()); iter != shapes.end(); ++iter){
-        (*iter)->out(os);
+    TextWriter writer(os);
+
+    writer << "Begin Image\n";
+    writer << "Begin Shapes\n";
+    if(storage == Storage::SHAPES){
+        for(std::vector<Shape*>::const_iterator iter(shapes.begin()); iter != shapes.end(); ++iter){
+            (*iter)->out(writer);
+        }
+    }else{
+        for(unsigned int i = 0; i < arrays.shapeCount; i++){
+            writeShape(writer, arrays.kinds[i], arrays.colors[i],
+                       arrays.verticies + 2 * arrays.vertexOffsets[i], arrays.flags[i]);
+        }
     }
-    os << "End Shapes" << std::endl;
-    os << "End Image" << std::endl;
+    writer << "End Shapes\n";
+    writer << "End Image\n";
     
     return os;
 }
@@ -118,28 +441,303 @@ std::ostream& Image::out(std::ostream& os){
  * 
  * Parameters:
  * 	iStream - reference to input file
+ *  storage - how the new image stores its shapes
  * 
  * Returns:
  *  pointer to image object
  */
-Image* Image::in(std::istream& iStream){
-    Image * image;
-    while(!iStream.eof()){
-        std::string line;
+Image* Image::in(std::istream& iStream, Storage storage){
+    std::string text;
+
+    // read what is left of the stream in one go, sized up front when the stream can seek
+    std::streampos start = iStream.tellg();
+    if(start != std::streampos(-1)){
+        iStream.seekg(0, std::ios::end);
+        std::streamoff available = iStream.tellg() - start;
+        iStream.seekg(start);
+        if(available > 0){
+            text.resize(available);
+            iStream.read(&text[0], available);
+            text.resize(iStream.gcount());
+        }
+    }
+    char buffer[65536];
+    while(iStream.read(buffer, sizeof(buffer)) || iStream.gcount() > 0){
+        text.append(buffer, iStream.gcount());
+    }
+
+    return parse(text, storage);
+}
+
+/* 
+ * Instantiates an Image object from the text of an image file. Markers are found anywhere in a
+ * line between records and must match whole lines within them. A record keeps the last color
+ * and verticies it gives, and one without verticies is skipped.
+ * 
+ * Parameters:
+ * 	text - contents of the file
+ *  storage - how the new image stores its shapes
+ *  threads - most threads to parse with, or 0 for one per core
+ * 
+ * Returns:
+ *  pointer to image object, or NULL if the text holds no image
+ */
+Image* Image::parse(std::string_view text, Storage storage, unsigned int threads){
+    Image* image = NULL;
+    std::size_t position = 0;
+    std::string_view line;
+
+    try{
+        while(nextLine(text, position, line)){
+            if(line.find("Begin Image") != std::string_view::npos){
+                delete image;
+                image = new Image(storage);
+                if(!image->parseChunks(text, position, threads)){
+                    parseShapes(text, position, image);
+                }
+            }else if(line.find("End Image") != std::string_view::npos){
+                return image;
+            }
+        }
+    }catch(...){
+        delete image;
+        throw;
+    }
+    return image;
+}
+
+/* 
+ * Parses the shapes section of a text image file in chunks on several threads and appends the
+ * shapes in file order. Each chunk starts at a line beginning a record and is parsed into an
+ * image of its own, every chunk but the last up to where the next one starts. When every chunk
+ * ends exactly where the next starts, the chunks were split between the same records that
+ * reading the section in one go finds, and give the same shapes. Otherwise, or if a chunk
+ * does not parse, nothing is appended so the section can be read in one go instead, which
+ * also throws the exception a malformed record should.
+ * 
+ * Parameters:
+ * 	text - the whole text
+ *  position - where the section starts, moved past it if the chunks were used
+ *  threads - most threads to parse with, or 0 for one per core
+ * 
+ * Returns:
+ *  true if the shapes were appended
+ */
+bool Image::parseChunks(std::string_view text, std::size_t& position, unsigned int threads){
+    if(threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    if(position >= text.size()) return false;
+    std::size_t chunkCount = std::min<std::size_t>(threads, (text.size() - position) / TEXT_CHUNK_SIZE);
+    if(chunkCount < 2) return false;
+
+    // starts[c] is where chunk c starts and where chunk c - 1 has to end
+    std::vector<std::size_t> starts(1, position);
+    std::size_t chunkSize = (text.size() - position) / chunkCount;
+    for(std::size_t c = 1; c < chunkCount; c++){
+        std::size_t start = recordStart(text, std::max(starts.back() + 1, position + c * chunkSize));
+        if(start == std::string_view::npos) break;
+        starts.push_back(start);
+    }
+    if(starts.size() < 2) return false;
+    starts.push_back(std::string_view::npos);
+
+    std::size_t chunks = starts.size() - 1;
+    std::vector<Image> parts(chunks, Image(Storage::PACKED));
+    std::vector<std::size_t> ends(starts.begin(), starts.end() - 1);
+    std::vector<char> split(chunks, false);
+
+    auto parseChunk = [&](std::size_t c){
+        try{
+            bool sectionEnded = parseShapes(text, ends[c], &parts[c], starts[c + 1]);
+            split[c] = c == chunks - 1 ? sectionEnded : !sectionEnded && ends[c] == starts[c + 1];
+        }catch(...){
+            split[c] = false;
+        }
+    };
+    std::vector<std::thread> workers;
+    for(std::size_t c = 1; c < chunks; c++){
+        try{
+            workers.emplace_back(parseChunk, c);
+        }catch(const std::system_error&){
+            // out of threads, so this one parses the chunk
+            parseChunk(c);
+        }
+    }
+    parseChunk(0);
+    for(std::thread& worker : workers){
+        worker.join();
+    }
+
+    if(std::find(split.begin(), split.end(), false) != split.end()) return false;
+
+    for(const Image& part : parts){
+        appendShapes(part);
+    }
+    position = ends.back();
+    return true;
+}
+
+/* 
+ * Writes the image in the binary scene format.
+ * 
+ * Parameters:
+ * 	os - reference to the output stream
+ * 
+ * Returns:
+ *  output stream being passed in
+ */
+std::ostream& Image::writeBinary(std::ostream& os) const{
+    uint64_t shapeCount = arrays.shapeCount;
+    uint64_t vertexCount = arrays.pointCount;
+
+    unsigned char header[BINARY_HEADER_SIZE];
+    writeHeader(header, shapeCount, vertexCount);
+    os.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+    writeArray(os, arrays.kinds, shapeCount, sizeof(ShapeKind));
+    writeArray(os, arrays.flags, shapeCount, sizeof(unsigned char));
+    writeArray(os, arrays.colors, shapeCount, sizeof(unsigned int));
+    writeArray(os, arrays.vertexOffsets, shapeCount, sizeof(unsigned int));
+    writeArray(os, arrays.verticies, 2 * vertexCount, sizeof(double));
+
+    return os;
+}
+
+/* 
+ * Reads an image written by writeBinary. Every array is checked before the image is built, so
+ * a truncated or damaged file gives NULL rather than a broken image.
+ * 
+ * Parameters:
+ * 	iStream - reference to input file
+ *  storage - how the new image stores its shapes
+ * 
+ * Returns:
+ *  pointer to image object, or NULL if the stream does not hold a valid binary image
+ */
+Image* Image::readBinary(std::istream& iStream, Storage storage){
+    unsigned char header[BINARY_HEADER_SIZE];
+    uint32_t headerSize;
+    uint64_t shapeCount, vertexCount;
+
+    if(!iStream.read(reinterpret_cast<char*>(header), sizeof(header)) ||
+            !readHeader(header, headerSize, shapeCount, vertexCount)){
+        return NULL;
+    }
+    iStream.ignore(headerSize - BINARY_HEADER_SIZE);
+
+    // don't trust the counts with an allocation the file could not possibly fill
+    std::streampos start = iStream.tellg();
+    if(start != std::streampos(-1)){
+        iStream.seekg(0, std::ios::end);
+        std::streamoff available = iStream.tellg() - start;
+        iStream.seekg(start);
+        if(available < 0 || (uint64_t)available < arraysSize(shapeCount, vertexCount)) return NULL;
+    }
+
+    Image* image = new Image(storage);
+    image->kinds.resize(shapeCount);
+    image->flags.resize(shapeCount);
+    image->colors.resize(shapeCount);
+    image->vertexOffsets.resize(shapeCount);
+    image->modelVerticies.resize(2 * vertexCount);
 
-        std::getline(iStream, line);
+    bool valid = readArray(iStream, image->kinds.data(), shapeCount, sizeof(ShapeKind)) &&
+                 readArray(iStream, image->flags.data(), shapeCount, sizeof(unsigned char)) &&
+                 readArray(iStream, image->colors.data(), shapeCount, sizeof(unsigned int)) &&
+                 readArray(iStream, image->vertexOffsets.data(), shapeCount, sizeof(unsigned int)) &&
+                 readArray(iStream, image->modelVerticies.data(), 2 * vertexCount, sizeof(double));
 
+    if(!valid || !validShapes(image->kinds.data(), image->vertexOffsets.data(), shapeCount, vertexCount)){
+        delete image;
+        return NULL;
+    }
 
-        if(line.find("Begin Image") != std::string::npos){
-            image = new Image();
-            image->shapes = readShapesFromFile(iStream);
-        } else if(line.find("End Image") != std::string::npos){
-            return image;
+    image->useVectors();
+    image->addShapes(0);
+    if(storage == Storage::SHAPES){
+        image->shapes.reserve(shapeCount);
+        for(unsigned int i = 0; i < shapeCount; i++){
+            image->shapes.push_back(image->placeShape(i));
         }
     }
     return image;
 }
 
+/* 
+ * Maps a file in the binary scene format into memory and returns a PACKED image that draws
+ * straight from the mapped arrays. Opening reads only the kinds and offsets to check them, and
+ * nothing is copied. The verticies are read when the spatial index is built by the first draw,
+ * after which only the pages of visible shapes are needed again. The file must not be
+ * changed or removed while the image uses it; unmap copies the arrays into memory first.
+ * 
+ * Parameters:
+ *  filename - path of the file
+ * 
+ * Returns:
+ *  pointer to image object, or NULL if the file could not be mapped or is not a valid binary
+ *  image, or the arrays cannot be used as they are on this machine
+ */
+Image* Image::mapBinary(const std::string& filename){
+    if(!isLittleEndian()) return NULL;
+
+    Image* image = new Image(Storage::PACKED);
+    MappedFile& mapping = image->mapping;
+
+    uint32_t headerSize;
+    uint64_t shapeCount, vertexCount;
+    if(!mapping.open(filename) || mapping.size() < BINARY_HEADER_SIZE ||
+            !readHeader(mapping.data(), headerSize, shapeCount, vertexCount) ||
+            mapping.size() < headerSize || mapping.size() - headerSize < arraysSize(shapeCount, vertexCount)){
+        delete image;
+        return NULL;
+    }
+
+    // the mapping starts on a page boundary and every array on an 8 byte one, so the arrays
+    // are aligned for their types
+    const unsigned char* array = mapping.data() + headerSize;
+    Arrays& arrays = image->arrays;
+    arrays.kinds = reinterpret_cast<const ShapeKind*>(array);
+    array += padded(shapeCount * sizeof(ShapeKind));
+    arrays.flags = array;
+    array += padded(shapeCount * sizeof(unsigned char));
+    arrays.colors = reinterpret_cast<const unsigned int*>(array);
+    array += padded(shapeCount * sizeof(unsigned int));
+    arrays.vertexOffsets = reinterpret_cast<const unsigned int*>(array);
+    array += padded(shapeCount * sizeof(unsigned int));
+    arrays.verticies = reinterpret_cast<const double*>(array);
+    arrays.shapeCount = shapeCount;
+    arrays.pointCount = vertexCount;
+
+    if(!validShapes(arrays.kinds, arrays.vertexOffsets, shapeCount, vertexCount)){
+        delete image;
+        return NULL;
+    }
+
+    image->addShapes(0);
+    return image;
+}
+
+/* 
+ * Returns whether a stream starts with the magic number of the binary scene format, leaving
+ * the stream where it was.
+ * 
+ * Parameters:
+ * 	iStream - reference to input file
+ * 
+ * Returns:
+ *  true if the stream holds a binary image
+ */
+bool Image::isBinary(std::istream& iStream){
+    char magic[sizeof(BINARY_MAGIC)];
+    std::streampos start = iStream.tellg();
+
+    bool binary = iStream.read(magic, sizeof(magic)) &&
+                  std::memcmp(magic, BINARY_MAGIC, sizeof(magic)) == 0;
+
+    iStream.clear();
+    iStream.seekg(start);
+    return binary;
+}
+
 /* 
  * This method will erase all shapes in the Image container.
  * 
@@ -150,12 +748,766 @@ Image* Image::in(std::istream& iStream){
  *   void
  */
 void Image::erase(){
+    // the shapes live in the arena, so they are destroyed in place and freed all at once
     for(std::vector<Shape*>::const_iterator iter(shapes.begin()); iter != shapes.end(); ++iter){
-        delete *iter;
+        (*iter)->~Shape();
     }
 
     shapes.erase(shapes.begin(), shapes.end());
+    arena.release();
+    kinds.clear();
+    colors.clear();
+    flags.clear();
+    vertexOffsets.clear();
+    modelVerticies.clear();
+    mapping.close();
+    useVectors();
+    index.clear();
+    deviceGenerations.clear();
+    visibleGeneration = 0;
+
+    // shapes that were drawn are gone, so only a full draw can update the window
+    drawnGeneration = 0;
+    damaged = false;
+}
+
+/* 
+ * Adds a shape that was placed in the arena to the container.
+ * 
+ * Parameters:
+ * 	shape - pointer to shape object.
+ * 
+ * Returns
+ *   void
+ */
+void Image::append(Shape* shape){
+    double packed[6];
+    shape->packVerticies(packed);
+
+    shapes.push_back(shape);
+    appendPacked(shape->getKind(), shape->getColor(), packed, shape->getFlags());
 }
 
+/* 
+ * Adds a shape to the packed arrays.
+ * 
+ * Parameters:
+ * 	kind - kind of shape
+ *  color - color of the shape
+ *  verticies - getVertexCount(kind) packed (x, y) pairs in model coordinates
+ *  flags - combination of SHAPE_ flags
+ * 
+ * Returns
+ *   void
+ */
+void Image::appendPacked(ShapeKind kind, unsigned int color, const double* verticies, unsigned char flags){
+    // the mapped file is never written, so the first edit copies it
+    unmap();
+
+    kinds.push_back(kind);
+    colors.push_back(color);
+    this->flags.push_back(flags);
+    vertexOffsets.push_back(modelVerticies.size() / 2);
+    modelVerticies.insert(modelVerticies.end(), verticies, verticies + 2 * getVertexCount(kind));
+    useVectors();
+
+    addShapes(arrays.shapeCount - 1);
+}
 
+/* 
+ * Adds copies of the shapes of another image to the end of the container, as adding them one
+ * at a time would.
+ * 
+ * Parameters:
+ * 	other - image holding the shapes, which may be mapped
+ * 
+ * Returns
+ *   void
+ */
+void Image::appendShapes(const Image& other){
+    unmap();
 
+    const Arrays& from = other.arrays;
+    unsigned int first = arrays.shapeCount;
+    unsigned int base = arrays.pointCount;
+    kinds.insert(kinds.end(), from.kinds, from.kinds + from.shapeCount);
+    colors.insert(colors.end(), from.colors, from.colors + from.shapeCount);
+    flags.insert(flags.end(), from.flags, from.flags + from.shapeCount);
+    for(unsigned int s = 0; s < from.shapeCount; s++){
+        vertexOffsets.push_back(base + from.vertexOffsets[s]);
+    }
+    modelVerticies.insert(modelVerticies.end(), from.verticies, from.verticies + 2 * from.pointCount);
+    useVectors();
+
+    addShapes(first);
+    if(storage == Storage::SHAPES){
+        for(unsigned int s = first; s < arrays.shapeCount; s++){
+            shapes.push_back(placeShape(s));
+        }
+    }
+}
+
+/* 
+ * Takes note of the shapes from first on, already in the packed arrays. They are put in the
+ * spatial index the next time it is searched, so loading a drawing does not have to go
+ * through all verticies. Until the window has been drawn there is nothing for them to damage,
+ * since drawDirty starts with a full draw.
+ * 
+ * Parameters:
+ * 	first - position of the first new shape
+ * 
+ * Returns
+ *   void
+ */
+void Image::addShapes(unsigned int first){
+    for(unsigned int s = first; drawnGeneration != 0 && s < arrays.shapeCount; s++){
+        SpatialIndex::Box box = boundingBox(s);
+        if(damaged){
+            damage.minX = std::min(damage.minX, box.minX);
+            damage.minY = std::min(damage.minY, box.minY);
+            damage.maxX = std::max(damage.maxX, box.maxX);
+            damage.maxY = std::max(damage.maxY, box.maxY);
+        }else{
+            damage = box;
+            damaged = true;
+        }
+    }
+
+    // the new shapes have not been transformed yet, and may be visible
+    deviceGenerations.resize(arrays.shapeCount, 0);
+    visibleGeneration = 0;
+}
+
+/* 
+ * Puts the shapes added since the spatial index was last searched into it.
+ * 
+ * Parameters:
+ * 	none
+ * 
+ * Returns
+ *   void
+ */
+void Image::updateIndex(){
+    for(unsigned int s = index.size(); s < arrays.shapeCount; s++){
+        index.insert(boundingBox(s));
+    }
+}
+
+/* 
+ * Returns the model space bounding box of a shape.
+ * 
+ * Parameters:
+ * 	shape - position of the shape
+ * 
+ * Returns
+ *   the bounding box
+ */
+SpatialIndex::Box Image::boundingBox(unsigned int shape) const{
+    const double* verticies = arrays.verticies + 2 * arrays.vertexOffsets[shape];
+
+    SpatialIndex::Box box = {verticies[0], verticies[1], verticies[0], verticies[1]};
+    for(unsigned int i = 1; i < getVertexCount(arrays.kinds[shape]); i++){
+        box.minX = std::min(box.minX, verticies[2*i]);
+        box.minY = std::min(box.minY, verticies[2*i+1]);
+        box.maxX = std::max(box.maxX, verticies[2*i]);
+        box.maxY = std::max(box.maxY, verticies[2*i+1]);
+    }
+    return box;
+}
+
+/* 
+ * Creates a Shape object in the arena from an entry in the packed arrays.
+ * 
+ * Parameters:
+ * 	index - position of the shape
+ * 
+ * Returns
+ *   pointer to the shape, which lives in the arena
+ */
+Shape* Image::placeShape(unsigned int index){
+    const double* verticies = arrays.verticies + 2 * arrays.vertexOffsets[index];
+
+    if(arrays.kinds[index] == ShapeKind::TRIANGLE){
+        Triangle* triangle = new (arena) Triangle(verticies, arrays.colors[index], arena);
+        triangle->setFilled(arrays.flags[index] & SHAPE_FILLED);
+        return triangle;
+    }
+    return new (arena) Line(verticies, arrays.colors[index], arena);
+}
+
+/* 
+ * Creates a new Shape object from an entry in the packed arrays.
+ * 
+ * Parameters:
+ * 	index - position of the shape
+ * 
+ * Returns
+ *   pointer to a new shape object
+ */
+Shape* Image::makeShape(unsigned int index) const{
+    if(index >= arrays.shapeCount) throw std::out_of_range("Image::getShape");
+
+    unsigned int count = getVertexCount(arrays.kinds[index]);
+    const double* packed = arrays.verticies + 2 * arrays.vertexOffsets[index];
+
+    matrix verticies(4, count);
+    for(unsigned int i = 0; i < count; i++){
+        verticies[0][i] = packed[2*i];
+        verticies[1][i] = packed[2*i+1];
+    }
+
+    if(arrays.kinds[index] == ShapeKind::TRIANGLE){
+        Triangle* triangle = new Triangle(&verticies, arrays.colors[index]);
+        triangle->setFilled(arrays.flags[index] & SHAPE_FILLED);
+        return triangle;
+    }
+    return new Line(&verticies, arrays.colors[index]);
+}
+
+/* 
+ * Converts an area of the window into a box in model coordinates that holds every point
+ * drawn into it. Device coordinates are truncated when drawn, so the area is grown by a pixel.
+ * 
+ * Parameters:
+ *  vc - view context used to convert from device coordinates
+ *  area - area of the window
+ * 
+ * Returns
+ *   bounding box in model coordinates
+ */
+SpatialIndex::Box Image::toModelArea(ViewContext* vc, const GraphicsContext::Rect& area) const{
+    double left = area.x - 1.0;
+    double top = area.y - 1.0;
+    double right = (double)area.x + area.width + 1.0;
+    double bottom = (double)area.y + area.height + 1.0;
+
+    PointBlock<4> corners;
+    corners[0] = Vec4(left, top);
+    corners[1] = Vec4(right, top);
+    corners[2] = Vec4(left, bottom);
+    corners[3] = Vec4(right, bottom);
+    corners = vc->deviceToModel(corners);
+
+    SpatialIndex::Box box = {corners[0].x, corners[0].y, corners[0].x, corners[0].y};
+    for(unsigned int i = 1; i < 4; i++){
+        box.minX = std::min(box.minX, corners[i].x);
+        box.minY = std::min(box.minY, corners[i].y);
+        box.maxX = std::max(box.maxX, corners[i].x);
+        box.maxY = std::max(box.maxY, corners[i].y);
+    }
+    return box;
+}
+
+/* 
+ * Clears an area of the window and draws every shape reaching into it again, in order and
+ * clipped to the area.
+ * 
+ * Parameters:
+ *  gc - pointer to a graphics context object
+ *  vc - view context used to convert to device coordinates
+ *  area - area of the window, not empty
+ * 
+ * Returns
+ *   void
+ */
+void Image::redrawArea(GraphicsContext* gc, ViewContext* vc, const GraphicsContext::Rect& area){
+    updateIndex();
+    index.query(toModelArea(vc, area), dirty);
+
+    gc->clearRect(area);
+    gc->setClip(area);
+    transformShapes(vc, dirty);
+    rasterizeShapes(gc, dirty);
+    gc->clearClip();
+}
+
+/* 
+ * Brings the device coordinates of some shapes up to date with the view. Consecutive shapes
+ * have consecutive verticies, so runs of stale shapes go to the transform kernel in one call,
+ * and after the view changes with everything visible that is a single pass over all verticies.
+ * 
+ * Parameters:
+ *  vc - view context used to convert to device coordinates
+ *  which - positions of the shapes, in increasing order
+ * 
+ * Returns
+ *   void
+ */
+void Image::transformShapes(ViewContext* vc, const std::vector<unsigned int>& which){
+    unsigned long generation = vc->getGeneration();
+
+    deviceVerticies.resize(2 * arrays.pointCount);
+    for(unsigned int v = 0; v < which.size(); ){
+        unsigned int first = which[v];
+        if(deviceGenerations[first] == generation){
+            v++;
+            continue;
+        }
+
+        unsigned int last = first;
+        deviceGenerations[first] = generation;
+        for(v++; v < which.size() && which[v] == last + 1 && deviceGenerations[last + 1] != generation; v++){
+            last++;
+            deviceGenerations[last] = generation;
+        }
+
+        unsigned int begin = arrays.vertexOffsets[first];
+        unsigned int end = arrays.vertexOffsets[last] + getVertexCount(arrays.kinds[last]);
+        vc->transformPoints(arrays.verticies + 2 * begin, deviceVerticies.data() + 2 * begin, end - begin);
+    }
+}
+
+/* 
+ * Rasterizes some shapes from their device coordinates, which must be up to date.
+ * 
+ * Parameters:
+ *  gc - pointer to a graphics context object
+ *  which - positions of the shapes, in the order they are drawn
+ * 
+ * Returns
+ *   void
+ */
+void Image::rasterizeShapes(GraphicsContext* gc, const std::vector<unsigned int>& which){
+    if(storage == Storage::SHAPES){
+        for(unsigned int i : which){
+            shapes[i]->rasterize(gc, deviceVerticies.data() + 2 * arrays.vertexOffsets[i]);
+        }
+    }else{
+        for(unsigned int i : which){
+            const double* verticies = deviceVerticies.data() + 2 * arrays.vertexOffsets[i];
+            switch(arrays.kinds[i]){
+                case ShapeKind::LINE:
+                    Line::rasterize(gc, verticies, arrays.colors[i]);
+                    break;
+                case ShapeKind::TRIANGLE:
+                    Triangle::rasterize(gc, verticies, arrays.colors[i], arrays.flags[i] & SHAPE_FILLED);
+                    break;
+            }
+        }
+    }
+}
+
+/* 
+ * Returns whether the image draws from a file mapped by mapBinary.
+ * 
+ * Parameters:
+ * 	none
+ * 
+ * Returns:
+ *  true if the image is mapped
+ */
+bool Image::isMapped() const{
+    return mapping.data() != NULL;
+}
+
+/* 
+ * Copies the arrays of a mapped image into memory and unmaps the file. Nothing happens if the
+ * image is not mapped.
+ * 
+ * Parameters:
+ * 	none
+ * 
+ * Returns
+ *   void
+ */
+void Image::unmap(){
+    if(!isMapped()) return;
+
+    kinds.assign(arrays.kinds, arrays.kinds + arrays.shapeCount);
+    colors.assign(arrays.colors, arrays.colors + arrays.shapeCount);
+    flags.assign(arrays.flags, arrays.flags + arrays.shapeCount);
+    vertexOffsets.assign(arrays.vertexOffsets, arrays.vertexOffsets + arrays.shapeCount);
+    modelVerticies.assign(arrays.verticies, arrays.verticies + 2 * arrays.pointCount);
+
+    mapping.close();
+    useVectors();
+}
+
+/* 
+ * Points the arrays the image draws from at the vectors, after they changed.
+ * 
+ * Parameters:
+ * 	none
+ * 
+ * Returns
+ *   void
+ */
+void Image::useVectors(){
+    arrays.kinds = kinds.data();
+    arrays.flags = flags.data();
+    arrays.colors = colors.data();
+    arrays.vertexOffsets = vertexOffsets.data();
+    arrays.verticies = modelVerticies.data();
+    arrays.shapeCount = kinds.size();
+    arrays.pointCount = modelVerticies.size() / 2;
+}
+
+/* 
+ * Returns whether the machine stores integers and doubles little-endian, as the binary scene
+ * format does.
+ * 
+ * Parameters:
+ * 	none
+ * 
+ * Returns:
+ *  true on a little-endian machine
+ */
+static bool isLittleEndian(){
+    const uint16_t probe = 1;
+    return *reinterpret_cast<const unsigned char*>(&probe) == 1;
+}
+
+/* 
+ * Rounds the size of an array up to the alignment of the arrays in the binary scene format.
+ * 
+ * Parameters:
+ * 	size - size of the array in bytes
+ * 
+ * Returns:
+ *  size including the padding
+ */
+static uint64_t padded(uint64_t size){
+    return (size + BINARY_ALIGNMENT - 1) / BINARY_ALIGNMENT * BINARY_ALIGNMENT;
+}
+
+/* 
+ * Returns the size of the arrays following the header of a binary scene file.
+ * 
+ * Parameters:
+ * 	shapeCount - number of shapes
+ *  vertexCount - number of (x, y) pairs
+ * 
+ * Returns:
+ *  size in bytes
+ */
+static uint64_t arraysSize(uint64_t shapeCount, uint64_t vertexCount){
+    return 2 * padded(shapeCount) + 2 * padded(4 * shapeCount) + 16 * vertexCount;
+}
+
+/* 
+ * Encodes the header of a binary scene file for this version.
+ * 
+ * Parameters:
+ * 	header - storage for BINARY_HEADER_SIZE bytes
+ *  shapeCount - number of shapes
+ *  vertexCount - number of (x, y) pairs
+ * 
+ * Returns:
+ *  void
+ */
+static void writeHeader(unsigned char* header, uint64_t shapeCount, uint64_t vertexCount){
+    std::memcpy(header, BINARY_MAGIC, sizeof(BINARY_MAGIC));
+
+    const uint64_t fields[HEADER_FIELDS] = {BINARY_VERSION, BINARY_HEADER_SIZE, shapeCount, vertexCount};
+    for(unsigned int f = 0; f < HEADER_FIELDS; f++){
+        for(unsigned int b = 0; b < HEADER_FIELD_SIZES[f]; b++){
+            header[HEADER_FIELD_OFFSETS[f] + b] = fields[f] >> (8 * b);
+        }
+    }
+}
+
+/* 
+ * Decodes and checks the header of a binary scene file. Later versions may add to the end of
+ * the header, but must keep the arrays as they are.
+ * 
+ * Parameters:
+ * 	header - the first BINARY_HEADER_SIZE bytes of the file
+ *  headerSize - receives the size of the whole header
+ *  shapeCount - receives the number of shapes
+ *  vertexCount - receives the number of (x, y) pairs
+ * 
+ * Returns:
+ *  true if the header belongs to a file this version can read
+ */
+static bool readHeader(const unsigned char* header, uint32_t& headerSize, uint64_t& shapeCount,
+                       uint64_t& vertexCount){
+    if(std::memcmp(header, BINARY_MAGIC, sizeof(BINARY_MAGIC)) != 0) return false;
+
+    uint64_t fields[HEADER_FIELDS] = {0, 0, 0, 0};
+    for(unsigned int f = 0; f < HEADER_FIELDS; f++){
+        for(unsigned int b = HEADER_FIELD_SIZES[f]; b-- > 0; ){
+            fields[f] = fields[f] << 8 | header[HEADER_FIELD_OFFSETS[f] + b];
+        }
+    }
+
+    headerSize = fields[1];
+    shapeCount = fields[2];
+    vertexCount = fields[3];
+    return fields[0] == BINARY_VERSION && headerSize >= BINARY_HEADER_SIZE &&
+           headerSize % BINARY_ALIGNMENT == 0 && shapeCount <= UINT_MAX && vertexCount <= UINT_MAX &&
+           vertexCount <= 3 * shapeCount;
+}
+
+/* 
+ * Checks that the shapes of a binary scene file are known kinds, packed one after the other
+ * without gaps, so every vertex offset is within the verticies.
+ * 
+ * Parameters:
+ * 	kinds - kind of each shape
+ *  vertexOffsets - position of the first (x, y) pair of each shape
+ *  shapeCount - number of shapes
+ *  vertexCount - number of (x, y) pairs
+ * 
+ * Returns:
+ *  true if the shapes are valid
+ */
+static bool validShapes(const ShapeKind* kinds, const unsigned int* vertexOffsets, uint64_t shapeCount,
+                        uint64_t vertexCount){
+    uint64_t offset = 0;
+    for(uint64_t i = 0; i < shapeCount; i++){
+        if((kinds[i] != ShapeKind::LINE && kinds[i] != ShapeKind::TRIANGLE) || vertexOffsets[i] != offset){
+            return false;
+        }
+        offset += getVertexCount(kinds[i]);
+    }
+    return offset == vertexCount;
+}
+
+/* 
+ * Writes an array in little-endian byte order, padded with zeros to a multiple of 8 bytes.
+ * 
+ * Parameters:
+ * 	os - reference to the output stream
+ *  data - the array
+ *  count - number of entries
+ *  size - size of an entry in bytes
+ * 
+ * Returns:
+ *  void
+ */
+static void writeArray(std::ostream& os, const void* data, uint64_t count, unsigned int size){
+    const char* bytes = static_cast<const char*>(data);
+    if(isLittleEndian() || size == 1){
+        os.write(bytes, count * size);
+    }else{
+        char swapped[8];
+        for(uint64_t i = 0; i < count; i++){
+            std::reverse_copy(bytes + i * size, bytes + (i + 1) * size, swapped);
+            os.write(swapped, size);
+        }
+    }
+
+    static const char zeros[BINARY_ALIGNMENT] = {0};
+    os.write(zeros, (BINARY_ALIGNMENT - count * size % BINARY_ALIGNMENT) % BINARY_ALIGNMENT);
+}
+
+/* 
+ * Reads an array written by writeArray, padding included.
+ * 
+ * Parameters:
+ * 	is - reference to the input stream
+ *  data - storage for the array
+ *  count - number of entries
+ *  size - size of an entry in bytes
+ * 
+ * Returns:
+ *  true if the whole array could be read
+ */
+static bool readArray(std::istream& is, void* data, uint64_t count, unsigned int size){
+    char* bytes = static_cast<char*>(data);
+    if(!is.read(bytes, count * size)) return false;
+
+    if(!isLittleEndian() && size > 1){
+        for(uint64_t i = 0; i < count; i++){
+            std::reverse(bytes + i * size, bytes + (i + 1) * size);
+        }
+    }
+
+    is.ignore((BINARY_ALIGNMENT - count * size % BINARY_ALIGNMENT) % BINARY_ALIGNMENT);
+    return true;
+}
+
+/* 
+ * Reads the next line of a text, the way std::getline would. A position past the end of the
+ * text stands for a stream with its end of file flag set. Reaching the end empties line, but
+ * once the flag is set line is left alone, as std::getline does.
+ * 
+ * Parameters:
+ * 	text - the whole text
+ *  position - where the line starts, moved past its end of line
+ *  line - receives the line without its end of line
+ * 
+ * Returns:
+ *  false if the text has been read to the end
+ */
+static bool nextLine(std::string_view text, std::size_t& position, std::string_view& line){
+    if(position > text.size()) return false;
+    if(position == text.size()){
+        line = std::string_view();
+        position++;
+        return false;
+    }
+
+    std::size_t end = text.find('\n', position);
+    if(end == std::string_view::npos){
+        // a last line without an end of line sets the flag
+        line = text.substr(position);
+        position = text.size() + 1;
+        return true;
+    }
+    line = text.substr(position, end - position);
+    position = end + 1;
+    return true;
+}
+
+/* 
+ * Reads an int the way std::stoi does: leading white space is skipped, a sign is allowed and
+ * reading stops at the first character that is not a digit.
+ * 
+ * Parameters:
+ * 	field - the text holding the number
+ * 
+ * Returns:
+ *  the number
+ */
+static int parseInt(std::string_view field){
+    std::size_t i = 0;
+    while(i < field.size() && std::isspace(static_cast<unsigned char>(field[i]))) i++;
+
+    // from_chars takes a minus sign but not a plus
+    if(i < field.size() && field[i] == '+'){
+        i++;
+        if(i == field.size() || field[i] < '0' || field[i] > '9') throw std::invalid_argument("stoi");
+    }
+
+    int value = 0;
+    std::from_chars_result result = std::from_chars(field.data() + i, field.data() + field.size(), value);
+    if(result.ec == std::errc::invalid_argument) throw std::invalid_argument("stoi");
+    if(result.ec == std::errc::result_out_of_range) throw std::out_of_range("stoi");
+    return value;
+}
+
+/* 
+ * Reads a vertex line such as "\t\tv1: 10,20". The x coordinate is taken to start at the
+ * seventh character and end at the comma.
+ * 
+ * Parameters:
+ * 	line - the vertex line
+ *  vertex - receives the (x, y) pair
+ * 
+ * Returns:
+ *  void
+ */
+static void parseVertex(std::string_view line, double* vertex){
+    std::size_t comma = line.find(',');
+    vertex[0] = parseInt(line.substr(6, comma - 6));
+    vertex[1] = parseInt(line.substr(comma + 1));
+}
+
+/* 
+ * Reads the rest of a Line or Triangle record, up to and including its end line.
+ * 
+ * Parameters:
+ * 	text - the whole text
+ *  position - where the record continues, moved past it
+ *  count - number of verticies of the shape, 3 for a triangle which may also be filled
+ *  end - the line ending the record
+ *  verticies - receives the verticies
+ *  color - receives the color, if the record has one
+ *  filled - receives whether the triangle is filled, if the record says
+ * 
+ * Returns:
+ *  true if the record held verticies
+ */
+static bool parseRecord(std::string_view text, std::size_t& position, unsigned int count,
+                        std::string_view end, double* verticies, unsigned int& color, bool& filled){
+    bool found = false;
+    std::string_view line;
+
+    // kept for the whole record, so a vertex line missing at the end of the text is the one
+    // read for that vertex earlier in the record
+    std::string_view vertexLines[3];
+
+    while(nextLine(text, position, line)){
+        if(line == "Begin Shape Properties"){
+            while(nextLine(text, position, line)){
+                if(line.find("Color:") != std::string_view::npos){
+                    color = parseInt(line.substr(8));
+                }else if(line.find("End Shape Properties") != std::string_view::npos){
+                    break;
+                }
+            }
+        }else if(line == "\tBegin Verticies"){
+            for(unsigned int v = 0; v < count; v++){
+                nextLine(text, position, vertexLines[v]);
+                parseVertex(vertexLines[v], verticies + 2 * v);
+            }
+            found = true;
+        }else if(count == 3 && line.substr(0, 7) == "\tFill: "){
+            filled = parseInt(line.substr(7)) != 0;
+        }else if(line == end){
+            return found;
+        }
+    }
+    return found;
+}
+
+/* 
+ * Reads the records of the shapes section of an image, up to and including its End Shapes
+ * line, and adds the shapes to an image. Reading can be stopped between records at a limit,
+ * to read part of the section.
+ * 
+ * Parameters:
+ * 	text - the whole text
+ *  position - where the section continues, moved past what was read
+ *  image - the image receiving the shapes
+ *  limit - where to stop if no record is being read, defaults to the end of the text
+ * 
+ * Returns:
+ *  true if the section was read to its end, false if reading stopped at limit
+ */
+static bool parseShapes(std::string_view text, std::size_t& position, Image* image, std::size_t limit){
+    std::string_view line;
+
+    while(position < limit){
+        if(!nextLine(text, position, line)) return true;
+
+        double verticies[6];
+        unsigned int color = GraphicsContext::WHITE;
+        bool filled = false;
+
+        if(line.find("Begin Line") != std::string_view::npos){
+            if(parseRecord(text, position, 2, "End Line", verticies, color, filled)){
+                image->add(ShapeKind::LINE, color, verticies);
+            }
+        }else if(line.find("Begin Triangle") != std::string_view::npos){
+            if(parseRecord(text, position, 3, "End Triangle", verticies, color, filled)){
+                image->add(ShapeKind::TRIANGLE, color, verticies, filled ? SHAPE_FILLED : 0);
+            }
+        }else if(line.find("End Shapes") != std::string_view::npos){
+            return true;
+        }
+    }
+    return false;
+}
+
+/* 
+ * Finds the first line at or after a position in a text that is a Begin Line or Begin Triangle
+ * line as out writes them. parseShapes takes any line holding one of these as the start of a
+ * record, but the property lines within a record hold them too.
+ * 
+ * Parameters:
+ * 	text - the whole text
+ *  from - where to start looking, moved on to the start of the next line unless it is one
+ * 
+ * Returns:
+ *  where the line starts, or npos if there is none
+ */
+static std::size_t recordStart(std::string_view text, std::size_t from){
+    std::size_t position = from;
+    if(position > 0 && text[position - 1] != '\n'){
+        position = text.find('\n', position);
+        if(position == std::string_view::npos) return position;
+        position++;
+    }
+
+    while(position < text.size()){
+        std::size_t end = std::min(text.find('\n', position), text.size());
+        std::string_view line = text.substr(position, end - position);
+        if(line == "Begin Line" || line == "Begin Triangle"){
+            return position;
+        }
+        position = end + 1;
+    }
+    return std::string_view::npos;
+}
@@ -7,9 +7,14 @@
 #ifndef _IMAGE_H
 #define _IMAGE_H
 
+#include <string>
+#include <string_view>
 #include <vector>
 
 #include "matrix.h"
+#include "Arena.h"
+#include "MappedFile.h"
+#include "SpatialIndex.h"
 #include "gcontext.h"
 #include "Colors.h"
 #include "Shape.h"
@@ -18,12 +23,23 @@
 class Image{
 
     public:
+        /* 
+        * How an Image keeps its shapes. Either way the verticies, colors and kinds of all shapes
+        * are kept in parallel arrays that drawing and saving walk through in order.
+        *   SHAPES - each shape is also kept as a Shape object, so subclasses of Shape keep their
+        *            own draw and out behavior. The shapes are carved out of an arena owned by
+        *            the image and freed together when the image is erased.
+        *   PACKED - only the arrays are kept. Much cheaper for large drawings, but only the shape
+        *            kinds in ShapeKind can be stored.
+        */
+        enum class Storage {SHAPES, PACKED};
+
         /* This is default constructor for creating an Image object.
         * 
         * Parameters:
-        *      none
+        *      storage - how shapes are stored, defaults to SHAPES
         */
-        Image();
+        Image(Storage storage = Storage::SHAPES);
 
         /* This is a copy constructor for the image class. This will create deep copies of all
         * shapes in the image class
@@ -65,16 +81,140 @@ class Image{
         void add(Shape* shape);
 
         /* 
-        * This method will iterate through the Image container and draw each image.
+        * Adds a shape given as packed verticies to the Image container. In SHAPES storage a
+        * Shape object is created for it.
+        * 
+        * Parameters:
+        * 	kind - kind of shape
+        *  color - color of the shape
+        *  verticies - getVertexCount(kind) packed (x, y) pairs in model coordinates
+        *  flags - combination of SHAPE_ flags, as returned by Shape::getFlags
+        * 
+        * Returns
+        *   void
+        */
+        void add(ShapeKind kind, unsigned int color, const double* verticies, unsigned char flags = 0);
+
+        /* 
+        * This method will draw every shape in the Image container that can be seen in the window.
+        * The window is converted into model coordinates and looked up in the spatial index, so
+        * shapes that are off screen are skipped entirely. Device coordinates are kept between
+        * frames along with the view generation they were computed for, so only shapes added or
+        * brought into view since the view last changed are transformed, and a repaint of an
+        * unchanged view only rasterizes. Each shape rasterizes from its slice of the device
+        * coordinates. The graphics context is flushed once all shapes are drawn.
         * 
         * Parameters:
         * 	gc - pointer to a graphics context object.
+        *  vc - pointer to the view context used to convert to device coordinates.
         * 
         * Returns: 
         *  void
         */
         void draw(GraphicsContext* gc, ViewContext* vc);
 
+        /* 
+        * This method will bring the window up to date after shapes were added, without a full
+        * redraw. Adding a shape marks its bounding box as damaged, and only the part of the
+        * window covering the accumulated damage is cleared and redrawn, with the shapes reaching
+        * into it drawn in order and clipped to it. The result is the same as draw, but the cost
+        * depends on the size of the damage rather than of the drawing. When the view or the
+        * window size changed since the last draw, or the image was erased, this is a full draw.
+        * 
+        * Parameters:
+        * 	gc - pointer to a graphics context object.
+        *  vc - pointer to the view context used to convert to device coordinates.
+        * 
+        * Returns: 
+        *  void
+        */
+        void drawDirty(GraphicsContext* gc, ViewContext* vc);
+
+        /* 
+        * This method will redraw an area of the window whose contents were lost, such as one
+        * that was just uncovered. The area is cleared and every shape reaching into it is drawn
+        * again in order, clipped to it. When the view or the window size changed since the last
+        * draw, or the image was erased, this is a full draw.
+        * 
+        * Parameters:
+        * 	gc - pointer to a graphics context object.
+        *  vc - pointer to the view context used to convert to device coordinates.
+        *  area - area of the window to redraw
+        * 
+        * Returns: 
+        *  void
+        */
+        void drawArea(GraphicsContext* gc, ViewContext* vc, const GraphicsContext::Rect& area);
+
+        /* 
+        * Returns the model coordinates of every shape's verticies as one packed buffer of (x, y)
+        * pairs, in the order the shapes were added. The buffer is valid until the image changes.
+        * 
+        * Parameters:
+        * 	none
+        * 
+        * Returns:
+        *  pointer to getPointCount() packed verticies
+        */
+        const double* getVerticies() const;
+
+        /* 
+        * Returns the number of (x, y) pairs returned by getVerticies.
+        * 
+        * Parameters:
+        * 	none
+        * 
+        * Returns:
+        *  number of verticies
+        */
+        unsigned int getPointCount() const;
+
+        /* 
+        * Returns the number of shapes in the Image container.
+        * 
+        * Parameters:
+        * 	none
+        * 
+        * Returns:
+        *  number of shapes
+        */
+        unsigned int size() const;
+
+        /* 
+        * Returns a copy of a shape in the Image container. A copy is returned to prevent
+        * manipulation of the image, and so that PACKED images can provide one as well.
+        * 
+        * Parameters:
+        * 	index - position of the shape, in the order shapes were added
+        * 
+        * Returns:
+        *  pointer to a new shape object, which the caller must delete
+        */
+        Shape* getShape(unsigned int index) const;
+
+        /* 
+        * Returns how the Image container stores its shapes.
+        * 
+        * Parameters:
+        * 	none
+        * 
+        * Returns:
+        *  storage of the image
+        */
+        Storage getStorage() const;
+
+        /* 
+        * Returns the allocation counters of the arena holding the shapes of a SHAPES image. They
+        * count every shape, color and vertex block placed in the arena since the image was created.
+        * 
+        * Parameters:
+        * 	none
+        * 
+        * Returns:
+        *  reference to the counters
+        */
+        const Arena::Stats& getAllocationStats() const;
+
         /* 
         * This method will print the properties of the image to an output stream
         * 
@@ -88,14 +228,110 @@ class Image{
 
         /* 
         * Reas in image from file and instantiates a Image object with shapes found in file.
+        * The rest of the stream is read into memory in one go and handed to parse.
         * 
         * Parameters:
         * 	iStream - reference to input file
+        *  storage - how the new image stores its shapes, defaults to SHAPES
         * 
         * Returns:
         *  pointer to image object
         */
-        static Image* in(std::istream& iStream);
+        static Image* in(std::istream& iStream, Storage storage = Storage::SHAPES);
+
+        /* 
+        * Instantiates an Image object from the text of an image file, in the format written by
+        * out. The text is read in a single pass without copying any of it, and numbers are read
+        * the way std::stoi reads them, so fractions are truncated and malformed numbers throw
+        * std::invalid_argument or std::out_of_range. A large shapes section is split between
+        * records into chunks that are parsed on their own threads, giving the same image.
+        * 
+        * Parameters:
+        * 	text - contents of the file
+        *  storage - how the new image stores its shapes, defaults to SHAPES
+        *  threads - most threads to parse with, defaults to 0 for one per core
+        * 
+        * Returns:
+        *  pointer to image object, or NULL if the text holds no image
+        */
+        static Image* parse(std::string_view text, Storage storage = Storage::SHAPES, unsigned int threads = 0);
+
+        /* 
+        * Writes the image in the binary scene format: a little-endian header holding a magic
+        * number, a version and the shape and vertex counts, followed by the kinds, flags,
+        * colors, vertex offsets and verticies of all shapes, each as one array starting on an
+        * 8 byte boundary. The stream should be opened in binary mode.
+        * 
+        * Parameters:
+        * 	os - reference to the output stream
+        * 
+        * Returns:
+        *  output stream being passed in
+        */
+        std::ostream& writeBinary(std::ostream& os) const;
+
+        /* 
+        * Reads an image written by writeBinary. The arrays are read in bulk straight into the
+        * new image. The stream should be opened in binary mode.
+        * 
+        * Parameters:
+        * 	iStream - reference to input file
+        *  storage - how the new image stores its shapes, defaults to SHAPES
+        * 
+        * Returns:
+        *  pointer to image object, or NULL if the stream does not hold a valid binary image
+        */
+        static Image* readBinary(std::istream& iStream, Storage storage = Storage::SHAPES);
+
+        /* 
+        * Returns whether a stream starts with the magic number of the binary scene format,
+        * leaving the stream where it was.
+        * 
+        * Parameters:
+        * 	iStream - reference to input file
+        * 
+        * Returns:
+        *  true if the stream holds a binary image
+        */
+        static bool isBinary(std::istream& iStream);
+
+        /* 
+        * Maps a file in the binary scene format into memory and returns a PACKED image that
+        * draws straight from the mapped arrays, so nothing is copied and the system reads in and
+        * drops pages as needed. The first change to the image copies the arrays into memory and
+        * unmaps the file. The file must not change while it is mapped.
+        * 
+        * Parameters:
+        *  filename - path of the file
+        * 
+        * Returns:
+        *  pointer to image object, or NULL if the file cannot be mapped or does not hold a valid
+        *  binary image
+        */
+        static Image* mapBinary(const std::string& filename);
+
+        /* 
+        * Returns whether the image draws from a file mapped by mapBinary.
+        * 
+        * Parameters:
+        * 	none
+        * 
+        * Returns:
+        *  true if the image is mapped
+        */
+        bool isMapped() const;
+
+        /* 
+        * Copies the arrays of a mapped image into memory and unmaps the file, so the file can be
+        * overwritten. Nothing happens if the image is not mapped.
+        * 
+        * Parameters:
+        * 	none
+        * 
+        * Returns:
+        *   void
+        */
+        void unmap();
 
         /* 
         * This method will erase all shapes in the Image container.
@@ -109,8 +345,138 @@ class Image{
         void erase();
 
     private:
+        Storage storage;
+
+        // only used with SHAPES storage, the shapes live in arena
         std::vector<Shape*> shapes;
+        Arena arena;
+
+        // one entry per shape
+        std::vector<ShapeKind> kinds;
+        std::vector<unsigned int> colors;
+        std::vector<unsigned char> flags;
+        std::vector<unsigned int> vertexOffsets;
+
+        // packed (x, y) model coordinates of all shapes
+        std::vector<double> modelVerticies;
+
+        /* 
+        * The per shape arrays and verticies everything reads from. They point into the vectors
+        * above, or into mapping for an image opened with mapBinary, whose vectors stay empty.
+        */
+        struct Arrays{
+            const ShapeKind* kinds;
+            const unsigned char* flags;
+            const unsigned int* colors;
+            const unsigned int* vertexOffsets;
+            const double* verticies;
+            unsigned int shapeCount;
+            unsigned int pointCount;
+        };
+        Arrays arrays;
+        MappedFile mapping;
 
+        // device coordinates of modelVerticies, kept between frames. Each shape's slice is only
+        // valid if its entry in deviceGenerations matches the generation of the view, and 0
+        // never does.
+        std::vector<double> deviceVerticies;
+        std::vector<unsigned long> deviceGenerations;
+
+        // model space bounding boxes of the shapes, brought up to date by updateIndex before it
+        // is searched, and the shapes found in the window by the last draw. visible is reused
+        // while the view, the window size and the shapes stay the same, which visibleGeneration
+        // of 0 rules out.
+        SpatialIndex index;
+        std::vector<unsigned int> visible;
+        unsigned long visibleGeneration;
+        int visibleWidth;
+        int visibleHeight;
+
+        // the view and window size the window was last fully drawn for, where a generation of 0
+        // means it has to be drawn again
+        unsigned long drawnGeneration;
+        int drawnWidth;
+        int drawnHeight;
+
+        // model space bounding box of the shapes added since the window was last brought up to
+        // date, and the shapes found reaching into an area being redrawn
+        SpatialIndex::Box damage;
+        bool damaged;
+        std::vector<unsigned int> dirty;
+
+        /* 
+        * Adds a shape that was placed in the arena to the container.
+        */
+        void append(Shape* shape);
+
+        /* 
+        * Adds a shape to the packed arrays.
+        */
+        void appendPacked(ShapeKind kind, unsigned int color, const double* verticies, unsigned char flags);
+
+        /* 
+        * Adds copies of the shapes of another image to the end of the container.
+        */
+        void appendShapes(const Image& other);
+
+        /* 
+        * Points arrays at the vectors, after they changed.
+        */
+        void useVectors();
+
+        /* 
+        * Takes note of the shapes from first on, already in the packed arrays, adding them to
+        * the damage.
+        */
+        void addShapes(unsigned int first);
+
+        /* 
+        * Parses the shapes section of a text image file in chunks on several threads and
+        * appends the shapes, if the section splits into chunks that parse the way reading it
+        * in one go would.
+        */
+        bool parseChunks(std::string_view text, std::size_t& position, unsigned int threads);
+
+        /* 
+        * Puts the shapes added since the spatial index was last searched into it.
+        */
+        void updateIndex();
+
+        /* 
+        * Returns the model space bounding box of a shape.
+        */
+        SpatialIndex::Box boundingBox(unsigned int shape) const;
+
+        /* 
+        * Creates a Shape object in the arena from an entry in the packed arrays.
+        */
+        Shape* placeShape(unsigned int index);
+
+        /* 
+        * Converts an area of the window into a box in model coordinates that holds every point
+        * drawn into it.
+        */
+        SpatialIndex::Box toModelArea(ViewContext* vc, const GraphicsContext::Rect& area) const;
+
+        /* 
+        * Clears an area of the window and draws every shape reaching into it again.
+        */
+        void redrawArea(GraphicsContext* gc, ViewContext* vc, const GraphicsContext::Rect& area);
+
+        /* 
+        * Brings the device coordinates of some shapes up to date with the view.
+        */
+        void transformShapes(ViewContext* vc, const std::vector<unsigned int>& which);
+
+        /* 
+        * Rasterizes some shapes from their device coordinates.
+        */
+        void rasterizeShapes(GraphicsContext* gc, const std::vector<unsigned int>& which);
+
+        /* 
+        * Creates a new Shape object from an entry in the packed arrays.
+        */
+        Shape* makeShape(unsigned int index) const;
 };
 
 #endif
@@ -6,6 +6,8 @@
 
 #include "Line.h"
 
+#include <utility>
+
 /* 
  * This is a constructor for a Line object.
  * 
@@ -25,7 +27,7 @@ Line::Line(unsigned int x0, unsigned int y0, unsigned int x1, unsigned int y1){
     (endPoints)[3][0] = 1;
     (endPoints)[3][1] = 1;
 
-    *verticies = endPoints;
+    *verticies = std::move(endPoints);
 }
 
 /* 
@@ -52,7 +54,7 @@ Line::Line(unsigned int x0, unsigned int y0, unsigned int x1, unsigned int y1,in
     (endPoints)[3][0] = 1;
     (endPoints)[3][1] = 1;
 
-    *verticies = endPoints;
+    *verticies = std::move(endPoints);
 }
 
 /* 
@@ -77,9 +79,48 @@ Line::Line(unsigned int x0, unsigned int y0, unsigned int x1, unsigned int y1, u
     (endPoints)[3][0] = 1;
     (endPoints)[3][1] = 1;
 
-    *verticies = endPoints;
+    *verticies = std::move(endPoints);
+}
+
+/* 
+ * This is a constructor for a Line object using a 4x2 matrix as end points.
+ * 
+ * Parameters:
+ * 	verticies - pointer to the matrix holding one end point per column
+ *  color - integer color value.
+ */
+Line::Line(matrix* verticies, unsigned int color)
+:Shape(color)
+{
+    (*verticies)[3][0] = 1;
+    (*verticies)[3][1] = 1;
+
+    *this->verticies = *verticies;
 }
 
+/* 
+ * This is a constructor for a Line object whose storage is carved out of an arena.
+ * 
+ * Parameters:
+ * 	verticies - 2 packed (x, y) pairs in model coordinates
+ *  color - integer color value.
+ *  arena - arena to carve storage from
+ */
+Line::Line(const double* verticies, unsigned int color, Arena& arena)
+:Shape(color, 2, verticies, arena)
+{}
+
+/* 
+ * This is a copy constructor for a Line object that carves its storage out of an arena.
+ * 
+ * Parameters:
+ * 	from - reference to line that will be copied.
+ *  arena - arena to carve storage from
+ */
+Line::Line(const Line& from, Arena& arena)
+:Shape(from, arena)
+{}
+
 /* 
  * This is a copy constructor for a Line object.
  * 
@@ -108,18 +149,40 @@ Line::~Line(){}
  *  none
  */
 void Line::draw(GraphicsContext* gc, ViewContext* vc){
-    gc->setColor(color->color);
+    PointBlock<2> deviceCoord = vc->modelToDevice(PointBlock<2>(*verticies));
+    double deviceVerticies[4] = {deviceCoord[0].x, deviceCoord[0].y, deviceCoord[1].x, deviceCoord[1].y};
 
-    // std::cout << "Model" << std::endl;
-    // verticies->out(std::cout);
-
-    matrix* deviceCoord = vc->modelToDevice(this->verticies);
+    rasterize(gc, deviceVerticies);
+}
 
-    // std::cout << "Device" << std::endl;
-    // deviceCoord->out(std::cout);
+/* 
+ * This method will draw the line object from verticies already in device coordinates
+ * 
+ * Parameters:
+ * 	gc - pointer to graphics context object
+ *  deviceVerticies - 2 packed (x, y) pairs in device coordinates
+ * 
+ * Returns:
+ *  none
+ */
+void Line::rasterize(GraphicsContext* gc, const double* deviceVerticies){
+    rasterize(gc, deviceVerticies, color->color);
+}
 
-    gc->drawLine((*deviceCoord)[0][0], (*deviceCoord)[1][0], (*deviceCoord)[0][1], (*deviceCoord)[1][1]);
-    delete deviceCoord;
+/* 
+ * Draws a line stored as packed verticies already in device coordinates.
+ * 
+ * Parameters:
+ * 	gc - pointer to graphics context object
+ *  deviceVerticies - 2 packed (x, y) pairs in device coordinates
+ *  color - color of the line
+ * 
+ * Returns:
+ *  none
+ */
+void Line::rasterize(GraphicsContext* gc, const double* deviceVerticies, unsigned int color){
+    gc->setColor(color);
+    gc->drawLine(deviceVerticies[0], deviceVerticies[1], deviceVerticies[2], deviceVerticies[3]);
 }
 
 /* 
@@ -132,53 +195,82 @@ void Line::draw(GraphicsContext* gc, ViewContext* vc){
  *  output stream being passed in
  */
 std::ostream& Line::out(std::ostream& os) const {
-    os << "Begin Line" << std::endl;
-    os << "Begin Line Properties" << std::endl;
-    os << "\tBegin Verticies" << std::endl;
-    os << "\t\tv1: " << (*verticies)[0][0] << "," << (*verticies)[1][0] << std::endl;
-    os << "\t\tv2: " << (*verticies)[0][1] << "," << (*verticies)[1][1] << std::endl;
-    os << "\tEnd Verticies" << std::endl;
-    os << "End Line Properties" << std::endl;
-    Shape::out(os);
-    os << "End Line" << std::endl;
+    double packed[4];
+    packVerticies(packed);
+
+    return write(os, packed, color->color);
+}
+
+/* 
+ * This method will print the properties of the line to a writer
+ * 
+ * Parameters:
+ * 	writer - reference to the writer
+ * 
+ * Returns:
+ *  writer being passed in
+ */
+TextWriter& Line::out(TextWriter& writer) const{
+    double packed[4];
+    packVerticies(packed);
+
+    return write(writer, packed, color->color);
+}
+
+/* 
+ * Prints a line stored as packed verticies in the same format as the out method.
+ * 
+ * Parameters:
+ * 	os - reference to the output stream
+ *  verticies - 2 packed (x, y) pairs in model coordinates
+ *  color - color of the line
+ * 
+ * Returns:
+ *  output stream being passed in
+ */
+std::ostream& Line::write(std::ostream& os, const double* verticies, unsigned int color){
+    TextWriter writer(os);
+    write(writer, verticies, color);
 
     return os;
 }
 
 /* 
- * Reads in a line from file and instantiates and returns the line object
+ * Prints a line stored as packed verticies into a writer, in the same format as the out method.
  * 
  * Parameters:
- * 	iStream - reference to input file
+ * 	writer - reference to the writer
+ *  verticies - 2 packed (x, y) pairs in model coordinates
+ *  color - color of the line
  * 
  * Returns:
- *  pointer to line object
- */
-Line* Line::in(std::istream& iStream){
-    std::string v1, v2;
-    Line * lineObj;
-    while(!iStream.eof()){
-        std::string line;
-
-        std::getline(iStream, line);
-
-        if(line.compare("Begin Shape Properties") == 0){
-            lineObj->Shape::in(iStream);
-        } else if(line.compare("\tBegin Verticies") == 0){
-            std::getline(iStream, v1);
-            std::getline(iStream, v2);
-
-            int x0 = std::stoi(v1.substr(6,v1.find(",")-6));
-            int y0 = std::stoi(v1.substr(v1.find(",")+1,v1.length()));
-            int x1 = std::stoi(v2.substr(6,v2.find(",")-6));
-            int y1 = std::stoi(v2.substr(v2.find(",")+1,v2.length()));
-
-            lineObj = new Line(x0,y0,x1,y1);
-        } else if(line.compare("End Line") == 0){
-            return lineObj;
-        }
-    }
-    return lineObj;
+ *  writer being passed in
+ */
+TextWriter& Line::write(TextWriter& writer, const double* verticies, unsigned int color){
+    writer << "Begin Line\n";
+    writer << "Begin Line Properties\n";
+    writer << "\tBegin Verticies\n";
+    writer << "\t\tv1: " << verticies[0] << "," << verticies[1] << "\n";
+    writer << "\t\tv2: " << verticies[2] << "," << verticies[3] << "\n";
+    writer << "\tEnd Verticies\n";
+    writer << "End Line Properties\n";
+    Shape::writeProperties(writer, verticies, color);
+    writer << "End Line\n";
+
+    return writer;
+}
+
+/* 
+ * Returns the kind of the shape.
+ * 
+ * Parameters:
+ * 	none
+ * 
+ * Returns:
+ *  ShapeKind::LINE
+ */
+ShapeKind Line::getKind() const{
+    return ShapeKind::LINE;
 }
 
 /* 
@@ -194,6 +286,20 @@ Shape& Line::clone(){
     return *(new Line(*this));
 }
 
+/* 
+ * Creates a copy of a line object in an arena. The copy must not be deleted, see
+ * Shape::clone(Arena&).
+ * 
+ * Parameters:
+ * 	arena - arena to place the copy in
+ * 
+ * Returns:
+ *  line object as a shape reference
+ */
+Shape& Line::clone(Arena& arena){
+    return *(new (arena) Line(*this, arena));
+}
+
 /* 
  * Overrides default = operator for easy assignment of line objects
  * 
@@ -204,9 +310,6 @@ Shape& Line::clone(){
  *  reference to line object
  */
 Line& Line::operator=(const Line& from){
-    delete verticies;
-    verticies = new matrix(*from.verticies);
-
     Shape::operator=(from);
     return *this;
 }
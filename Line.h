@@ -57,6 +57,34 @@ class Line: public Shape{
         Line(unsigned int x0, unsigned int y0, unsigned int x1, unsigned int y1,
              unsigned int color);
 
+        /* 
+        * This is a constructor for a Line object using a 4x2 matrix as end points.
+        * 
+        * Parameters:
+        * 	verticies - pointer to the matrix holding one end point per column
+        *  color - integer color value.
+        */
+        Line(matrix* verticies, unsigned int color);
+
+        /* 
+        * This is a constructor for a Line object whose storage is carved out of an arena.
+        * 
+        * Parameters:
+        * 	verticies - 2 packed (x, y) pairs in model coordinates
+        *  color - integer color value.
+        *  arena - arena to carve storage from
+        */
+        Line(const double* verticies, unsigned int color, Arena& arena);
+
+        /* 
+        * This is a copy constructor for a Line object that carves its storage out of an arena.
+        * 
+        * Parameters:
+        * 	from - reference to line that will be copied.
+        *  arena - arena to carve storage from
+        */
+        Line(const Line& from, Arena& arena);
+
         /* 
         * This is a copy constructor for a Line object.
         * 
@@ -84,6 +112,18 @@ class Line: public Shape{
         */
         void draw(GraphicsContext*, ViewContext*);
 
+        /* 
+        * This method will draw the line object from verticies already in device coordinates
+        * 
+        * Parameters:
+        * 	gc - pointer to graphics context object
+        *  deviceVerticies - 2 packed (x, y) pairs in device coordinates
+        * 
+        * Returns:
+        *  none
+        */
+        void rasterize(GraphicsContext* gc, const double* deviceVerticies);
+
         /* 
         * This method will print the properties of the line to an output stream
         * 
@@ -96,15 +136,67 @@ class Line: public Shape{
         std::ostream& out(std::ostream& os) const;
 
         /* 
-        * Reads in a line from file and instantiates and returns the line object
+        * This method will print the properties of the line to a writer
+        * 
+        * Parameters:
+        * 	writer - reference to the writer
+        * 
+        * Returns:
+        *  writer being passed in
+        */
+        TextWriter& out(TextWriter& writer) const;
+
+        /* 
+        * Returns the kind of the shape.
         * 
         * Parameters:
-        * 	iStream - reference to input file
+        * 	none
+        * 
+        * Returns:
+        *  ShapeKind::LINE
+        */
+        ShapeKind getKind() const;
+
+        /* 
+        * Draws a line stored as packed verticies already in device coordinates. This is what the
+        * rasterize method uses, and is shared with containers that do not keep Shape objects.
+        * 
+        * Parameters:
+        * 	gc - pointer to graphics context object
+        *  deviceVerticies - 2 packed (x, y) pairs in device coordinates
+        *  color - color of the line
+        * 
+        * Returns:
+        *  none
+        */
+        static void rasterize(GraphicsContext* gc, const double* deviceVerticies, unsigned int color);
+
+        /* 
+        * Prints a line stored as packed verticies in the same format as the out method.
+        * 
+        * Parameters:
+        * 	os - reference to the output stream
+        *  verticies - 2 packed (x, y) pairs in model coordinates
+        *  color - color of the line
+        * 
+        * Returns:
+        *  output stream being passed in
+        */
+        static std::ostream& write(std::ostream& os, const double* verticies, unsigned int color);
+
+        /* 
+        * Prints a line stored as packed verticies into a writer, in the same format as the out
+        * method.
+        * 
+        * Parameters:
+        * 	writer - reference to the writer
+        *  verticies - 2 packed (x, y) pairs in model coordinates
+        *  color - color of the line
         * 
         * Returns:
-        *  pointer to line object
+        *  writer being passed in
         */
-        static Line* in(std::istream& iStream);
+        static TextWriter& write(TextWriter& writer, const double* verticies, unsigned int color);
 
         /* 
         * Creates a copy of a line object, but returns a refernce to the line as a shape reference
@@ -117,6 +209,18 @@ class Line: public Shape{
         */
         Shape& clone();
 
+        /* 
+        * Creates a copy of a line object in an arena. The copy must not be deleted, see
+        * Shape::clone(Arena&).
+        * 
+        * Parameters:
+        * 	arena - arena to place the copy in
+        * 
+        * Returns:
+        *  line object as a shape reference
+        */
+        Shape& clone(Arena& arena);
+
         /* 
         * Overrides default = operator for easy assignment of line objects
         * 
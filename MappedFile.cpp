@@ -0,0 +1,101 @@
+/**
+ * MappedFile.cpp - This is an implementation of the MappedFile class
+ */
+
+#include "MappedFile.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* 
+ * This is a constructor for a MappedFile with no file mapped.
+ */
+MappedFile::MappedFile()
+:address(NULL), length(0)
+{}
+
+/* 
+ * This is a destructor for a MappedFile. The file is unmapped.
+ * 
+ * Parameters:
+ * 	none
+ */
+MappedFile::~MappedFile(){
+    close();
+}
+
+/* 
+ * Maps a whole file into memory, unmapping the file mapped before. The mapping is private, so
+ * nothing is ever written back to the file, and the descriptor is not needed once it exists.
+ * 
+ * Parameters:
+ *  filename - path of the file
+ * 
+ * Returns:
+ *  true if the file could be mapped
+ */
+bool MappedFile::open(const std::string& filename){
+    close();
+
+    int descriptor = ::open(filename.c_str(), O_RDONLY);
+    if(descriptor < 0) return false;
+
+    struct stat status;
+    if(fstat(descriptor, &status) != 0 || status.st_size <= 0){
+        ::close(descriptor);
+        return false;
+    }
+
+    void* mapped = mmap(NULL, status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    ::close(descriptor);
+    if(mapped == MAP_FAILED) return false;
+
+    address = mapped;
+    length = status.st_size;
+    return true;
+}
+
+/* 
+ * Unmaps the file, if one is mapped.
+ * 
+ * Parameters:
+ * 	none
+ * 
+ * Returns:
+ *  void
+ */
+void MappedFile::close(){
+    if(address != NULL){
+        munmap(address, length);
+        address = NULL;
+        length = 0;
+    }
+}
+
+/* 
+ * Returns the contents of the file, page aligned, or NULL if no file is mapped.
+ * 
+ * Parameters:
+ * 	none
+ * 
+ * Returns:
+ *  pointer to the first byte of the file
+ */
+const unsigned char* MappedFile::data() const{
+    return static_cast<const unsigned char*>(address);
+}
+
+/* 
+ * Returns the size of the mapped file in bytes, 0 if no file is mapped.
+ * 
+ * Parameters:
+ * 	none
+ * 
+ * Returns:
+ *  size of the file
+ */
+std::size_t MappedFile::size() const{
+    return length;
+}
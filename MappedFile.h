@@ -0,0 +1,82 @@
+/**
+ * MappedFile.h - Interface for the MappedFile class, a read-only memory mapping of a whole
+ *                file. Pages are read in from the file when they are first touched, and can
+ *                be dropped again by the system since they are never written.
+ */
+
+#ifndef _MAPPEDFILE_H
+#define _MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+
+class MappedFile{
+
+    public:
+        /* 
+        * This is a constructor for a MappedFile with no file mapped.
+        */
+        MappedFile();
+
+        /* 
+        * This is a destructor for a MappedFile. The file is unmapped.
+        * 
+        * Parameters:
+        * 	none
+        */
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        /* 
+        * Maps a whole file into memory, unmapping the file mapped before. The file should not be
+        * changed while it is mapped.
+        * 
+        * Parameters:
+        *  filename - path of the file
+        * 
+        * Returns:
+        *  true if the file could be mapped
+        */
+        bool open(const std::string& filename);
+
+        /* 
+        * Unmaps the file, if one is mapped.
+        * 
+        * Parameters:
+        * 	none
+        * 
+        * Returns:
+        *  void
+        */
+        void close();
+
+        /* 
+        * Returns the contents of the file, page aligned, or NULL if no file is mapped.
+        * 
+        * Parameters:
+        * 	none
+        * 
+        * Returns:
+        *  pointer to the first byte of the file
+        */
+        const unsigned char* data() const;
+
+        /* 
+        * Returns the size of the mapped file in bytes, 0 if no file is mapped.
+        * 
+        * Parameters:
+        * 	none
+        * 
+        * Returns:
+        *  size of the file
+        */
+        std::size_t size() const;
+
+    private:
+        void* address;
+        std::size_t length;
+};
+
+#endif
@@ -25,7 +25,8 @@ MyDrawing::MyDrawing(ViewContext* vc){
     mode = Mode::POINT;
     color = GraphicsContext::WHITE;
     rubberBandMode = false;
-    image = new Image();
+    fillMode = false;
+    image = new Image(Image::Storage::PACKED);
     x0 = x1 = y0 = y1 = 0;
     m1 = new matrix(4,3);
     (*m1)[3][0] = 1;
@@ -54,8 +55,25 @@ MyDrawing::~MyDrawing(){
  *      none
  */
 void MyDrawing::paint(GraphicsContext* gc){
+    gc->beginFrame();
     gc->clear();
     image->draw(gc,vc);
+    gc->endFrame();
+}
+
+/* 
+ * This function handles the exposure event for part of the window. Only the exposed area is
+ * erased and redrawn.
+ * Inputs:
+ *      gc - GraphicsContext object
+ *      area - area of the window that was exposed
+ * Outputs:
+ *      none
+ */
+void MyDrawing::paint(GraphicsContext* gc, const GraphicsContext::Rect& area){
+    gc->beginFrame();
+    image->drawArea(gc,vc,area);
+    gc->endFrame();
 }
 
 /* 
@@ -101,6 +119,9 @@ void MyDrawing::mouseButtonDown(GraphicsContext* gc, unsigned int button, int x,
  *      none
  */
 void MyDrawing::mouseButtonUp(GraphicsContext* gc, unsigned int button, int x, int y){
+    // the rubber band is taken down and the new shape drawn in one frame
+    gc->beginFrame();
+
     if(rubberBandMode){
         if(mode == Mode::LINE || (mode == Mode::TRIANGLE && clicks==1)){
             //old line undraw
@@ -125,11 +146,15 @@ void MyDrawing::mouseButtonUp(GraphicsContext* gc, unsigned int button, int x, i
         std::cout << "Shape drawn!" << std::endl;
         Shape* s = createShape();
         image->add(s);
-        s->draw(gc,vc);
+        delete s;
+
+        // only the area under the new shape is redrawn
+        image->drawDirty(gc,vc);
         remakeMatrix();
         clicks=0;
     }
 
+    gc->endFrame();
     mouseState = Mouse::RELEASED;
 }
 
@@ -187,6 +212,7 @@ void MyDrawing::mouseMove(GraphicsContext* gc, int x, int y){
 void MyDrawing::keyDown(GraphicsContext* gc, unsigned int keycode){
     Mode newMode = mode;
     unsigned int oldColor = color;
+    gc->beginFrame();
     switch(keycode){
         case 'p':
         case 'P':
@@ -208,6 +234,14 @@ void MyDrawing::keyDown(GraphicsContext* gc, unsigned int keycode){
         case 'R':
             rubberBandMode = !rubberBandMode;
             break;
+        case 'g':
+        case 'G':
+            fillMode = !fillMode;
+            break;
+        case 'b':
+        case 'B':
+            saveBinaryToFile();
+            break;
         case 's':
         case 'S':
             saveToFile();
@@ -295,6 +329,8 @@ void MyDrawing::keyDown(GraphicsContext* gc, unsigned int keycode){
     if(color != oldColor){
         gc->setColor(color);
     }
+
+    gc->endFrame();
 }
 
 /* 
@@ -306,12 +342,34 @@ void MyDrawing::keyDown(GraphicsContext* gc, unsigned int keycode){
  *      none
  */
 void MyDrawing::saveToFile(){
+    // the image may be drawing from the file about to be overwritten
+    image->unmap();
+
     std::ofstream myfile;
     myfile.open(filename);
     image->out(myfile);
     myfile.close();
 }
 
+/* 
+ * This is a helper function for saving an image to file in the binary scene format, which
+ * loadFromFile recognizes and maps. This function requres no inputs as it uses the file scoped
+ * state variables.
+ * Inputs:
+ *      none
+ * Outputs:
+ *      none
+ */
+void MyDrawing::saveBinaryToFile(){
+    // the image may be drawing from the file about to be overwritten
+    image->unmap();
+
+    std::ofstream myfile;
+    myfile.open(filename, std::ios::binary);
+    image->writeBinary(myfile);
+    myfile.close();
+}
+
 /* 
  * This is a helper function for loading an image to file. This function requres no inputs as it
  * uses the file scoped state variables.
@@ -322,8 +380,20 @@ void MyDrawing::saveToFile(){
  */
 void MyDrawing::loadFromFile(){
     std::ifstream myfile;
-    myfile.open(filename);
-    image = Image::in(myfile);
+    myfile.open(filename, std::ios::binary);
+    delete image;
+
+    // the file may be in either format, the binary one starts with its magic number and is
+    // drawn straight from a mapping of the file if possible
+    if(Image::isBinary(myfile)){
+        image = Image::mapBinary(filename);
+        if(image == NULL) image = Image::readBinary(myfile, Image::Storage::PACKED);
+    }else{
+        image = Image::in(myfile, Image::Storage::PACKED);
+    }
+
+    // an unreadable file leaves an empty drawing
+    if(image == NULL) image = new Image(Image::Storage::PACKED);
     myfile.close();
 }
 
@@ -354,7 +424,11 @@ Shape* MyDrawing::createShape(){
     matrix * mtemp = vc->deviceToModel(m1);
     if(mode == Mode::POINT) return new Line((*mtemp)[0][0],(*mtemp)[1][0],(*mtemp)[0][0],(*mtemp)[1][0], color);
     if(mode == Mode::LINE) return new Line((*mtemp)[0][0],(*mtemp)[1][0],(*mtemp)[0][1],(*mtemp)[1][1], color);
-    if(mode == Mode::TRIANGLE) return new Triangle(mtemp,color);
+    if(mode == Mode::TRIANGLE){
+        Triangle* triangle = new Triangle(mtemp,color);
+        triangle->setFilled(fillMode);
+        return triangle;
+    }
     if(mode == Mode::CIRCLE) return NULL;   //todo
     delete mtemp;
 
@@ -405,8 +479,11 @@ void MyDrawing::printHelp(){
                  "\t\tp-point\tl-line\tt-triangle\tc-circle\n"
                  "\tRubber band mode:\n"
                  "\t\tr - toggle rubber band mode\n"
+                 "\tFilled triangles:\n"
+                 "\t\tg - toggle filling new triangles\n"
                  "\tSaving and loading to file:\n"
                  "\t\ts - save to image.txt\tf - load image.txt from file\n"
+                 "\t\tb - save to image.txt in the binary format, which f also loads\n"
                  "\tSwitch Color:\n"
                  "\t\t0 - White\t1 - Black\t2 - Green\t3 - Red\n"
                  "\t\t4 - Cyan\t5 - Magenta\t6 - Yellow\t7 - Gray\n"
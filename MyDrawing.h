@@ -41,6 +41,17 @@ class MyDrawing : public DrawingBase {
         */
         virtual void paint(GraphicsContext* gc);
 
+        /* 
+        * This function handles the exposure event for part of the window. Only the exposed area
+        * is erased and redrawn.
+        * Inputs:
+        *      gc - GraphicsContext object
+        *      area - area of the window that was exposed
+        * Outputs:
+        *      none
+        */
+        virtual void paint(GraphicsContext* gc, const GraphicsContext::Rect& area);
+
         /* 
         * This function handles the button down event. When this happens, a pixel is added to the 
         * screen and the state of the drawing process is updated.
@@ -115,6 +126,8 @@ class MyDrawing : public DrawingBase {
 
         bool rubberBandMode;
 
+        bool fillMode;
+
         /* 
         * This is a helper function for printing the help menu.
         * Inputs:
@@ -152,6 +165,17 @@ class MyDrawing : public DrawingBase {
         */
         void saveToFile();
 
+        /* 
+        * This is a helper function for saving an image to file in the binary scene format, which
+        * loadFromFile recognizes and maps. This function requres no inputs as it uses the file
+        * scoped state variables.
+        * Inputs:
+        *      none
+        * Outputs:
+        *      none
+        */
+        void saveBinaryToFile();
+
         /* 
         * This is a helper function for loading an image to file. This function requres no inputs as it
         * uses the file scoped state variables.
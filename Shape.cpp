@@ -5,8 +5,6 @@
  */
 
 #include "Shape.h"
-#include "Line.h"
-#include "Triangle.h"
 
 /* 
  * This is a constructor for a Shape object. A default shape is created.
@@ -14,7 +12,9 @@
  * Parameters:
  * 	none
  */
-Shape::Shape(){
+Shape::Shape()
+:inArena(false)
+{
     color = new Color();
     verticies = new matrix(4,1);
 }
@@ -42,6 +42,7 @@ Shape::Shape(unsigned int x0, unsigned int y0)
  *  blue - color value for blue
  */
 Shape::Shape(int red, int green, int blue)
+:inArena(false)
 {
     color = new Color(red, green, blue);
     verticies = new matrix(4,1);
@@ -53,7 +54,9 @@ Shape::Shape(int red, int green, int blue)
  * Parameters:
  *  color - integer value for color
  */
-Shape::Shape(unsigned int color){
+Shape::Shape(unsigned int color)
+:inArena(false)
+{
     this->color = new Color(color);
     verticies = new matrix(4,1);
 }
@@ -96,11 +99,55 @@ Shape::Shape(unsigned int x0, unsigned int y0, int red, int green, int blue)
  * Parameters:
  * 	from - reference to line that will be copied.
  */
-Shape::Shape(const Shape& from){
+Shape::Shape(const Shape& from)
+:inArena(false)
+{
     color = new Color((*from.color).getRed(), (*from.color).getGreen(), (*from.color).getBlue());
     verticies = new matrix(*from.verticies);
 }
 
+/* 
+ * This is a constructor for a Shape object whose color and verticies are carved out of an
+ * arena rather than allocated individually.
+ * 
+ * Parameters:
+ * 	color - integer value of color
+ *  vertexCount - number of verticies
+ *  verticies - vertexCount packed (x, y) pairs in model coordinates
+ *  arena - arena to carve storage from
+ */
+Shape::Shape(unsigned int color, unsigned int vertexCount, const double* verticies, Arena& arena)
+:inArena(true)
+{
+    this->color = new (arena) Color(color);
+    this->verticies = new (arena) matrix(4, vertexCount,
+                                         arena.allocate(matrix::storageSize(4, vertexCount), alignof(double)));
+
+    for(unsigned int i = 0; i < vertexCount; i++){
+        (*this->verticies)[0][i] = verticies[2*i];
+        (*this->verticies)[1][i] = verticies[2*i+1];
+        (*this->verticies)[3][i] = 1;
+    }
+}
+
+/* 
+ * This is a copy constructor for a Shape object that carves its storage out of an arena.
+ * 
+ * Parameters:
+ * 	from - reference to shape that will be copied.
+ *  arena - arena to carve storage from
+ */
+Shape::Shape(const Shape& from, Arena& arena)
+:inArena(true)
+{
+    unsigned int rows = from.verticies->getRows();
+    unsigned int cols = from.verticies->getCols();
+
+    color = new (arena) Color(from.color->color);
+    verticies = new (arena) matrix(rows, cols, arena.allocate(matrix::storageSize(rows, cols), alignof(double)));
+    *verticies = *from.verticies;
+}
+
 /* 
  * This is a destructor for a Shape object.
  * 
@@ -108,6 +155,12 @@ Shape::Shape(const Shape& from){
  * 	none
  */
 Shape::~Shape(){
+    if(inArena){
+        // the arena frees the storage itself, so only the matrix needs tearing down
+        verticies->~matrix();
+        return;
+    }
+
     delete color;
     delete verticies;
 }
@@ -122,36 +175,65 @@ Shape::~Shape(){
  *  output stream being passed in
  */
 std::ostream& Shape::out(std::ostream& os) const {
-    os << "Begin Shape Properties" << std::endl;
-    os << "\tColor: " << color->color << std::endl;
-    os << "\tLocation: " << (*verticies)[0][0] << "," << (*verticies)[1][0] << std::endl;
-    os << "End Shape Properties" << std::endl;
+    double location[2] = {(*verticies)[0][0], (*verticies)[1][0]};
 
-    return os;
+    return writeProperties(os, location, color->color);
 }
 
 /* 
- * Reads in a Shape from file and assigns the shape properties. A shape object will already
- * be instantiated when this is called, so a shape object is not returned.
+ * This method will print the properties of the Shape to a writer. The writer is flushed and
+ * the shape printed to its stream with the stream out method, so that subclasses only
+ * overriding that one are saved as they print themselves.
  * 
  * Parameters:
- * 	iStream - reference to input file
+ * 	writer - reference to the writer
  * 
  * Returns:
- *  void
+ *  writer being passed in
+ */
+TextWriter& Shape::out(TextWriter& writer) const{
+    out(writer.flush());
+
+    return writer;
+}
+
+/* 
+ * Prints the shape properties section for a shape stored as packed verticies. This is what
+ * Shape::out prints, and is shared with containers that do not keep Shape objects.
+ * 
+ * Parameters:
+ * 	os - reference to the output stream
+ *  verticies - packed (x, y) pairs of the shape in model coordinates
+ *  color - color of the shape
+ * 
+ * Returns:
+ *  output stream being passed in
  */
-void Shape::in(std::istream& iStream){
-    while(!iStream.eof()){
-        std::string line;
+std::ostream& Shape::writeProperties(std::ostream& os, const double* verticies, unsigned int color){
+    TextWriter writer(os);
+    writeProperties(writer, verticies, color);
 
-        std::getline(iStream, line);
+    return os;
+}
 
-        if(line.find("Color:") != std::string::npos){
-            color->color = std::stoi(line.substr(8,line.length()));
-        } else if(line.find("End Shape Properties") != std::string::npos){
-            return;
-        }
-    }
+/* 
+ * Prints the shape properties section for a shape stored as packed verticies into a writer.
+ * 
+ * Parameters:
+ * 	writer - reference to the writer
+ *  verticies - packed (x, y) pairs of the shape in model coordinates
+ *  color - color of the shape
+ * 
+ * Returns:
+ *  writer being passed in
+ */
+TextWriter& Shape::writeProperties(TextWriter& writer, const double* verticies, unsigned int color){
+    writer << "Begin Shape Properties\n";
+    writer << "\tColor: " << color << "\n";
+    writer << "\tLocation: " << verticies[0] << "," << verticies[1] << "\n";
+    writer << "End Shape Properties\n";
+
+    return writer;
 }
 
 /* 
@@ -164,11 +246,8 @@ void Shape::in(std::istream& iStream){
  *  void
  */
 void Shape::operator=(const Shape& from){
-    delete color;
-    delete verticies;
-
-    color = new Color((*from.color).color);
-    verticies = new matrix(*from.verticies);
+    color->color = from.color->color;
+    *verticies = *from.verticies;
 }
 
 /* 
@@ -185,6 +264,62 @@ matrix* Shape::getVerticies(){
     return new matrix(*verticies);
 }
 
+/* 
+ * Returns the color of the shape as a 24-bit RGB value.
+ * 
+ * Parameters:
+ * 	none
+ * 
+ * Returns:
+ *  color of shape
+ */
+unsigned int Shape::getColor() const{
+    return color->color;
+}
+
+/* 
+ * Returns the flags describing how the shape is drawn. Shapes that can't be filled
+ * have none.
+ * 
+ * Parameters:
+ * 	none
+ * 
+ * Returns:
+ *  combination of SHAPE_ flags
+ */
+unsigned char Shape::getFlags() const{
+    return 0;
+}
+
+/* 
+ * Returns the number of verticies in the shape.
+ * 
+ * Parameters:
+ * 	none
+ * 
+ * Returns:
+ *  number of verticies
+ */
+unsigned int Shape::getVertexCount() const{
+    return verticies->getCols();
+}
+
+/* 
+ * Writes the model coordinates of the shape verticies as packed (x, y) pairs.
+ * 
+ * Parameters:
+ * 	out - storage for getVertexCount() (x, y) pairs
+ * 
+ * Returns:
+ *  void
+ */
+void Shape::packVerticies(double* out) const{
+    for(unsigned int i = 0; i < verticies->getCols(); i++){
+        out[2*i] = (*verticies)[0][i];
+        out[2*i+1] = (*verticies)[1][i];
+    }
+}
+
 /* 
  * This is a default constructor for a Color object. Color becomes white
  * 
@@ -256,34 +391,3 @@ int Shape::Color::getGreen(){
 int Shape::Color::getBlue(){
     return (color&0x0000FF);
 }
-
-/* 
- * This is a global function not associated with a class which allows shapes to be read from
- * file and instantiated.
- * 
- * Parameters:
- *  in - reference to input stream
- * 
- * Returns:
- *  vector of shape objects
- */
-std::vector<Shape*> readShapesFromFile(std::istream& in){
-    std::vector<Shape*> shapes;
-
-    while(!in.eof()){
-        std::string line;
-
-        std::getline(in, line);
-
-        if(line.find("Begin Line") != std::string::npos){
-            shapes.push_back(Line::in(in));
-        }else if(line.find("Begin Triangle") != std::string::npos){
-            shapes.push_back(Triangle::in(in));
-        }else if(line.find("End Shapes") != std::string::npos){
-            return shapes;
-        }
-    }
-    return shapes;
-}
-
-
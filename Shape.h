@@ -14,12 +14,39 @@
 #include <iomanip>
 
 #include "matrix.h"
+#include "Arena.h"
 #include "gcontext.h"
 #include "Colors.h"
 #include "ViewContext.h"
+#include "TextWriter.h"
 
 class ViewContext;
 
+/* 
+ * Identifies the concrete type of a shape. This is what containers store in place of a Shape
+ * object when they keep shapes as plain arrays of verticies and colors.
+ */
+enum class ShapeKind : unsigned char {LINE, TRIANGLE};
+
+/* 
+ * Returns the number of verticies a shape of the given kind has.
+ * 
+ * Parameters:
+ *  kind - kind of shape
+ * 
+ * Returns:
+ *  number of verticies
+ */
+inline unsigned int getVertexCount(ShapeKind kind){
+    return kind == ShapeKind::TRIANGLE ? 3 : 2;
+}
+
+/* 
+ * Bits describing how a shape is drawn, as returned by Shape::getFlags.
+ *  SHAPE_FILLED - the inside of the shape is filled rather than only its outline drawn
+ */
+static const unsigned char SHAPE_FILLED = 0x01;
+
 class Shape{
 
     class Color{
@@ -163,6 +190,20 @@ class Shape{
 
         virtual void draw(GraphicsContext*, ViewContext*)=0;
 
+        /* 
+        * Draws the shape from verticies that have already been converted into device coordinates.
+        * This allows a container to transform many shapes at once and then have each of them
+        * rasterize from its slice of the result.
+        * 
+        * Parameters:
+        * 	gc - pointer to graphics context object
+        *  deviceVerticies - getVertexCount() packed (x, y) pairs in device coordinates
+        * 
+        * Returns:
+        *  none
+        */
+        virtual void rasterize(GraphicsContext* gc, const double* deviceVerticies)=0;
+
         /* 
         * This method will print the properties of the Shape to an output stream
         * 
@@ -175,17 +216,18 @@ class Shape{
         virtual std::ostream& out(std::ostream& os) const;
 
         /* 
-        * Reads in a Shape from file and assigns the shape properties. A shape object will already
-        * be instantiated when this is called, so a shape object is not returned.
+        * This method will print the properties of the Shape to a writer. By default the writer
+        * is flushed and the shape printed to its stream with the stream out method, so that
+        * subclasses only overriding that one are saved as they print themselves.
         * 
         * Parameters:
-        * 	iStream - reference to input file
+        * 	writer - reference to the writer
         * 
         * Returns:
-        *  void
+        *  writer being passed in
         */
-        void in(std::istream& iStream);
-        
+        virtual TextWriter& out(TextWriter& writer) const;
+
         /* 
         * Returns a copy of the shape verticies. A copy is returned to prevent manipulation of the
         * shape properties.
@@ -198,9 +240,127 @@ class Shape{
         */
         matrix* getVerticies();
 
+        /* 
+        * Returns the number of verticies in the shape.
+        * 
+        * Parameters:
+        * 	none
+        * 
+        * Returns:
+        *  number of verticies
+        */
+        unsigned int getVertexCount() const;
+
+        /* 
+        * Writes the model coordinates of the shape verticies as packed (x, y) pairs.
+        * 
+        * Parameters:
+        * 	out - storage for getVertexCount() (x, y) pairs
+        * 
+        * Returns:
+        *  void
+        */
+        void packVerticies(double* out) const;
+
         virtual Shape& clone()=0;
 
+        /* 
+        * Copies the shape into an arena. The shape, its color and its verticies are all carved
+        * out of the arena, so the copy must not be deleted. Instead its destructor is called
+        * directly, before the arena is released.
+        * 
+        * Parameters:
+        * 	arena - arena to place the copy in
+        * 
+        * Returns:
+        *  reference to the copy
+        */
+        virtual Shape& clone(Arena& arena)=0;
+
+        /* 
+        * Returns the kind of the shape.
+        * 
+        * Parameters:
+        * 	none
+        * 
+        * Returns:
+        *  kind of shape
+        */
+        virtual ShapeKind getKind() const=0;
+
+        /* 
+        * Returns the flags describing how the shape is drawn. Shapes that can't be filled
+        * have none.
+        * 
+        * Parameters:
+        * 	none
+        * 
+        * Returns:
+        *  combination of SHAPE_ flags
+        */
+        virtual unsigned char getFlags() const;
+
+        /* 
+        * Returns the color of the shape as a 24-bit RGB value.
+        * 
+        * Parameters:
+        * 	none
+        * 
+        * Returns:
+        *  color of shape
+        */
+        unsigned int getColor() const;
+
+        /* 
+        * Prints the shape properties section for a shape stored as packed verticies. This is what
+        * Shape::out prints, and is shared with containers that do not keep Shape objects.
+        * 
+        * Parameters:
+        * 	os - reference to the output stream
+        *  verticies - packed (x, y) pairs of the shape in model coordinates
+        *  color - color of the shape
+        * 
+        * Returns:
+        *  output stream being passed in
+        */
+        static std::ostream& writeProperties(std::ostream& os, const double* verticies, unsigned int color);
+
+        /* 
+        * Prints the shape properties section for a shape stored as packed verticies into a
+        * writer, so that many shapes can be saved without going through the stream for each.
+        * 
+        * Parameters:
+        * 	writer - reference to the writer
+        *  verticies - packed (x, y) pairs of the shape in model coordinates
+        *  color - color of the shape
+        * 
+        * Returns:
+        *  writer being passed in
+        */
+        static TextWriter& writeProperties(TextWriter& writer, const double* verticies, unsigned int color);
+
     protected:
+        /* 
+        * This is a constructor for a Shape object whose color and verticies are carved out of an
+        * arena rather than allocated individually.
+        * 
+        * Parameters:
+        * 	color - integer value of color
+        *  vertexCount - number of verticies
+        *  verticies - vertexCount packed (x, y) pairs in model coordinates
+        *  arena - arena to carve storage from
+        */
+        Shape(unsigned int color, unsigned int vertexCount, const double* verticies, Arena& arena);
+
+        /* 
+        * This is a copy constructor for a Shape object that carves its storage out of an arena.
+        * 
+        * Parameters:
+        * 	from - reference to shape that will be copied.
+        *  arena - arena to carve storage from
+        */
+        Shape(const Shape& from, Arena& arena);
+
         /* 
         * Overrides default = operator for easy assignment of shape properties
         * 
@@ -215,18 +375,9 @@ class Shape{
         Color* color;
         matrix* verticies;
 
-};
+        // true when color and verticies were carved out of an arena, which frees them
+        bool inArena;
 
-/* 
- * This is a global function not associated with a class which allows shapes to be read from
- * file and instantiated.
- * 
- * Parameters:
- *  in - reference to input stream
- * 
- * Returns:
- *  vector of shape objects
- */
-std::vector<Shape*> readShapesFromFile(std::istream& in);
+};
 
 #endif
\ No newline at end of file
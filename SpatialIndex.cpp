@@ -0,0 +1,188 @@
+/**
+ * SpatialIndex.cpp - This is an implementation of the SpatialIndex class
+ */
+
+#include "SpatialIndex.h"
+
+#include <algorithm>
+#include <cmath>
+
+// cells further out than this are merged into the outermost ones
+static const long long CELL_LIMIT = 1LL << 30;
+
+/* 
+ * This is a constructor for an empty SpatialIndex.
+ * 
+ * Parameters:
+ *  cellSize - width and height of a grid cell in model coordinates
+ */
+SpatialIndex::SpatialIndex(double cellSize)
+:cellSize(cellSize), queryCount(0)
+{}
+
+/* 
+ * Adds a box to the index. A box is listed in every cell it overlaps, unless it would be
+ * listed in so many that it is cheaper to test it on every query.
+ * 
+ * Parameters:
+ *  box - bounding box of the shape
+ * 
+ * Returns:
+ *  void
+ */
+void SpatialIndex::insert(const Box& box){
+    unsigned int index = boxes.size();
+    boxes.push_back(box);
+    stamps.push_back(queryCount);
+
+    long long firstColumn = cellOf(box.minX);
+    long long lastColumn = cellOf(box.maxX);
+    long long firstRow = cellOf(box.minY);
+    long long lastRow = cellOf(box.maxY);
+
+    if((lastColumn - firstColumn + 1) * (lastRow - firstRow + 1) > MAX_CELLS_PER_BOX){
+        oversized.push_back(index);
+        return;
+    }
+
+    for(long long row = firstRow; row <= lastRow; row++){
+        for(long long column = firstColumn; column <= lastColumn; column++){
+            cells[cellKey(column, row)].push_back(index);
+        }
+    }
+}
+
+/* 
+ * Finds every box that intersects an area. When the area covers more cells than are
+ * occupied, the occupied cells are walked instead of the area.
+ * 
+ * Parameters:
+ *  area - the area to search
+ *  result - receives the numbers of the boxes found, in increasing order
+ * 
+ * Returns:
+ *  void
+ */
+void SpatialIndex::query(const Box& area, std::vector<unsigned int>& result){
+    result.clear();
+
+    // a new stamp for this query, starting over if the counter wraps around
+    if(++queryCount == 0){
+        std::fill(stamps.begin(), stamps.end(), 0);
+        queryCount = 1;
+    }
+
+    long long firstColumn = cellOf(area.minX);
+    long long lastColumn = cellOf(area.maxX);
+    long long firstRow = cellOf(area.minY);
+    long long lastRow = cellOf(area.maxY);
+
+    if((lastColumn - firstColumn + 1) * (lastRow - firstRow + 1) > (long long)cells.size()){
+        for(std::unordered_map<unsigned long long, std::vector<unsigned int> >::const_iterator
+                iter(cells.begin()); iter != cells.end(); ++iter){
+            for(unsigned int index : iter->second){
+                collect(index, area, result);
+            }
+        }
+    }else{
+        for(long long row = firstRow; row <= lastRow; row++){
+            for(long long column = firstColumn; column <= lastColumn; column++){
+                std::unordered_map<unsigned long long, std::vector<unsigned int> >::const_iterator
+                    cell = cells.find(cellKey(column, row));
+                if(cell == cells.end()) continue;
+
+                for(unsigned int index : cell->second){
+                    collect(index, area, result);
+                }
+            }
+        }
+    }
+
+    for(unsigned int index : oversized){
+        collect(index, area, result);
+    }
+
+    std::sort(result.begin(), result.end());
+}
+
+/* 
+ * Removes every box from the index.
+ * 
+ * Parameters:
+ * 	none
+ * 
+ * Returns:
+ *   void
+ */
+void SpatialIndex::clear(){
+    boxes.clear();
+    cells.clear();
+    oversized.clear();
+    stamps.clear();
+}
+
+/* 
+ * Returns the number of boxes in the index.
+ * 
+ * Parameters:
+ * 	none
+ * 
+ * Returns:
+ *  number of boxes
+ */
+unsigned int SpatialIndex::size() const{
+    return boxes.size();
+}
+
+/* 
+ * Returns the column or row of the cell holding a coordinate.
+ * 
+ * Parameters:
+ *  coordinate - x or y in model coordinates
+ * 
+ * Returns:
+ *  the column for an x coordinate or the row for a y coordinate
+ */
+long long SpatialIndex::cellOf(double coordinate) const{
+    double cell = std::floor(coordinate / cellSize);
+
+    // written so that NaN lands in a cell as well
+    if(!(cell > -CELL_LIMIT)) return -CELL_LIMIT;
+    if(!(cell < CELL_LIMIT)) return CELL_LIMIT;
+    return (long long)cell;
+}
+
+/* 
+ * Combines a column and row into the key of a cell.
+ * 
+ * Parameters:
+ *  column - column of the cell
+ *  row - row of the cell
+ * 
+ * Returns:
+ *  key of the cell
+ */
+unsigned long long SpatialIndex::cellKey(long long column, long long row){
+    return ((unsigned long long)(column + CELL_LIMIT) << 32) | (unsigned long long)(row + CELL_LIMIT);
+}
+
+/* 
+ * Adds a box to the result of the current query unless it is already there or misses
+ * the area.
+ * 
+ * Parameters:
+ *  index - number of the box
+ *  area - the area being searched
+ *  result - the boxes found so far
+ * 
+ * Returns:
+ *  void
+ */
+void SpatialIndex::collect(unsigned int index, const Box& area, std::vector<unsigned int>& result){
+    if(stamps[index] == queryCount) return;
+    stamps[index] = queryCount;
+
+    if(boxes[index].intersects(area)){
+        result.push_back(index);
+    }
+}
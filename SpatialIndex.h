@@ -0,0 +1,119 @@
+/**
+ * SpatialIndex.h - Interface for the SpatialIndex class, a uniform grid of bounding boxes
+ *                  used to find the shapes of an image that overlap an area.
+ */
+
+#ifndef _SPATIALINDEX_H
+#define _SPATIALINDEX_H
+
+#include <unordered_map>
+#include <vector>
+
+class SpatialIndex{
+
+    public:
+        /* 
+        * An axis aligned box in model coordinates. The edges are part of the box.
+        */
+        struct Box{
+            double minX;
+            double minY;
+            double maxX;
+            double maxY;
+
+            /* 
+            * Returns whether two boxes share at least one point.
+            */
+            bool intersects(const Box& other) const{
+                return minX <= other.maxX && other.minX <= maxX &&
+                       minY <= other.maxY && other.minY <= maxY;
+            }
+        };
+
+        /* 
+        * This is a constructor for an empty SpatialIndex.
+        * 
+        * Parameters:
+        *  cellSize - width and height of a grid cell in model coordinates
+        */
+        SpatialIndex(double cellSize = 64.0);
+
+        /* 
+        * Adds a box to the index. Boxes are numbered in the order they are inserted, starting
+        * from 0, so the number matches the position of the shape in its image.
+        * 
+        * Parameters:
+        *  box - bounding box of the shape
+        * 
+        * Returns:
+        *  void
+        */
+        void insert(const Box& box);
+
+        /* 
+        * Finds every box that intersects an area.
+        * 
+        * Parameters:
+        *  area - the area to search
+        *  result - receives the numbers of the boxes found, in increasing order
+        * 
+        * Returns:
+        *  void
+        */
+        void query(const Box& area, std::vector<unsigned int>& result);
+
+        /* 
+        * Removes every box from the index.
+        * 
+        * Parameters:
+        * 	none
+        * 
+        * Returns:
+        *   void
+        */
+        void clear();
+
+        /* 
+        * Returns the number of boxes in the index.
+        * 
+        * Parameters:
+        * 	none
+        * 
+        * Returns:
+        *  number of boxes
+        */
+        unsigned int size() const;
+
+    private:
+        // boxes covering more cells than this are kept in oversized rather than in the grid
+        static const long long MAX_CELLS_PER_BOX = 64;
+
+        double cellSize;
+        std::vector<Box> boxes;
+
+        // the numbers of the boxes overlapping each occupied cell, keyed by cellKey
+        std::unordered_map<unsigned long long, std::vector<unsigned int> > cells;
+        std::vector<unsigned int> oversized;
+
+        // the query each box was last found by, so boxes in several cells are reported once
+        std::vector<unsigned int> stamps;
+        unsigned int queryCount;
+
+        /* 
+        * Returns the column or row of the cell holding a coordinate.
+        */
+        long long cellOf(double coordinate) const;
+
+        /* 
+        * Combines a column and row into the key of a cell.
+        */
+        static unsigned long long cellKey(long long column, long long row);
+
+        /* 
+        * Adds a box to the result of the current query unless it is already there or misses
+        * the area.
+        */
+        void collect(unsigned int index, const Box& area, std::vector<unsigned int>& result);
+};
+
+#endif
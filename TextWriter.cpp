@@ -0,0 +1,137 @@
+/**
+ * TextWriter.cpp - This is an implementation of the TextWriter class
+ */
+
+#include "TextWriter.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+
+// size of the buffer, written out whenever it fills up
+static const std::size_t BUFFER_SIZE = 1 << 18;
+
+// the buffer of the last writer on each thread, handed on to the next one
+static thread_local std::vector<char> spare;
+
+// room kept for a number besides its significant digits: sign, point, leading zeros and exponent
+static const std::size_t NUMBER_SIZE = 32;
+
+// a double has at most 767 significant decimal digits and %g drops trailing zeros, so any
+// higher precision prints the same characters as this one
+static const int MAX_PRECISION = 800;
+
+/* 
+ * This is a constructor for a TextWriter writing to a stream. Doubles are written with the
+ * precision the stream has now. The buffer of the writer before it on the thread is reused.
+ * 
+ * Parameters:
+ * 	os - reference to the output stream
+ */
+TextWriter::TextWriter(std::ostream& os)
+:os(os), precision(std::min<std::streamsize>(os.precision(), MAX_PRECISION)), used(0)
+{
+    buffer.swap(spare);
+    if(buffer.size() < BUFFER_SIZE) buffer.resize(BUFFER_SIZE);
+}
+
+/* 
+ * This is a destructor for a TextWriter. What is left in the buffer is written to the stream,
+ * and the buffer is kept for the next writer on the thread.
+ * 
+ * Parameters:
+ * 	none
+ */
+TextWriter::~TextWriter(){
+    flush();
+    spare.swap(buffer);
+}
+
+/* 
+ * Appends text. Text longer than the buffer is written straight to the stream.
+ * 
+ * Parameters:
+ * 	text - the text
+ * 
+ * Returns:
+ *  this writer
+ */
+TextWriter& TextWriter::operator<<(std::string_view text){
+    reserve(text.size());
+    if(text.size() > buffer.size()){
+        os.write(text.data(), text.size());
+        return *this;
+    }
+    std::memcpy(buffer.data() + used, text.data(), text.size());
+    used += text.size();
+    return *this;
+}
+
+/* 
+ * Appends a double the way the stream prints it by default, which is std::printf's %g with
+ * the precision of the stream. std::to_chars gives the same characters without going through
+ * the locale. The room reserved holds the longest %g at the precision, so the number always
+ * fits.
+ * 
+ * Parameters:
+ * 	value - the number
+ * 
+ * Returns:
+ *  this writer
+ */
+TextWriter& TextWriter::operator<<(double value){
+    reserve(std::max(precision, 0) + NUMBER_SIZE);
+    std::to_chars_result result = std::to_chars(buffer.data() + used, buffer.data() + buffer.size(),
+                                                value, std::chars_format::general, precision);
+    // never happens with the room reserved, but nothing past what was written may be kept
+    if(result.ec == std::errc()){
+        used = result.ptr - buffer.data();
+    }
+    return *this;
+}
+
+/* 
+ * Appends an unsigned int in decimal.
+ * 
+ * Parameters:
+ * 	value - the number
+ * 
+ * Returns:
+ *  this writer
+ */
+TextWriter& TextWriter::operator<<(unsigned int value){
+    reserve(NUMBER_SIZE);
+    used = std::to_chars(buffer.data() + used, buffer.data() + buffer.size(), value).ptr - buffer.data();
+    return *this;
+}
+
+/* 
+ * Writes what is in the buffer to the stream, so that more can be written to the stream
+ * directly. The stream itself is not flushed.
+ * 
+ * Parameters:
+ * 	none
+ * 
+ * Returns:
+ *  the output stream
+ */
+std::ostream& TextWriter::flush(){
+    if(used > 0){
+        os.write(buffer.data(), used);
+        used = 0;
+    }
+    return os;
+}
+
+/* 
+ * Makes room for at least count more characters, writing the buffer out if need be.
+ * 
+ * Parameters:
+ * 	count - number of characters
+ * 
+ * Returns:
+ *  void
+ */
+void TextWriter::reserve(std::size_t count){
+    if(buffer.size() - used < count) flush();
+}
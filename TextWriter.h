@@ -0,0 +1,103 @@
+/**
+ * TextWriter.h - Interface for the TextWriter class, which formats text into a large buffer and
+ *                writes it to an output stream in big chunks. Numbers come out as the stream
+ *                would print them with its default format flags, without going through the
+ *                stream for every one of them. Only the precision of the stream is honoured;
+ *                its format flags, such as fixed, scientific and showpoint, and its locale are
+ *                ignored.
+ */
+
+#ifndef _TEXTWRITER_H
+#define _TEXTWRITER_H
+
+#include <cstddef>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+class TextWriter{
+
+    public:
+        /* 
+        * This is a constructor for a TextWriter writing to a stream. Doubles are written with
+        * the precision the stream has now, but not its format flags or locale. Writers on a
+        * thread reuse one buffer.
+        * 
+        * Parameters:
+        * 	os - reference to the output stream
+        */
+        TextWriter(std::ostream& os);
+
+        /* 
+        * This is a destructor for a TextWriter. What is left in the buffer is written to the
+        * stream.
+        * 
+        * Parameters:
+        * 	none
+        */
+        ~TextWriter();
+
+        TextWriter(const TextWriter&) = delete;
+        TextWriter& operator=(const TextWriter&) = delete;
+
+        /* 
+        * Appends text.
+        * 
+        * Parameters:
+        * 	text - the text
+        * 
+        * Returns:
+        *  this writer
+        */
+        TextWriter& operator<<(std::string_view text);
+
+        /* 
+        * Appends a double the way the stream prints it with its default format flags, which is
+        * std::printf's %g with the precision of the stream.
+        * 
+        * Parameters:
+        * 	value - the number
+        * 
+        * Returns:
+        *  this writer
+        */
+        TextWriter& operator<<(double value);
+
+        /* 
+        * Appends an unsigned int in decimal.
+        * 
+        * Parameters:
+        * 	value - the number
+        * 
+        * Returns:
+        *  this writer
+        */
+        TextWriter& operator<<(unsigned int value);
+
+        /* 
+        * Writes what is in the buffer to the stream, so that more can be written to the stream
+        * directly. The stream itself is not flushed.
+        * 
+        * Parameters:
+        * 	none
+        * 
+        * Returns:
+        *  the output stream
+        */
+        std::ostream& flush();
+
+    private:
+        std::ostream& os;
+        int precision;
+
+        // buffer holds used characters, and is written out when a number might not fit
+        std::vector<char> buffer;
+        std::size_t used;
+
+        /* 
+        * Makes room for at least count more characters, writing the buffer out if need be.
+        */
+        void reserve(std::size_t count);
+};
+
+#endif
@@ -5,13 +5,17 @@
  */
 #include "Triangle.h"
 
+#include <utility>
+
 /* 
  * This is a constructor for a Triangle object using a matrix as verticies.
  * 
  * Parameters:
  * 	verticies - pointer to the verticies object to be used as triangle coordinates
  */
-Triangle::Triangle(matrix* verticies){
+Triangle::Triangle(matrix* verticies)
+:filled(false)
+{
     (*verticies)[3][0] = 1;
     (*verticies)[3][1] = 1;
     (*verticies)[3][2] = 1;
@@ -29,7 +33,7 @@ Triangle::Triangle(matrix* verticies){
  *  blue - color value for blue
  */
 Triangle::Triangle(matrix* verticies, int red, int green, int blue)
-:Shape(red,green,blue)
+:Shape(red,green,blue), filled(false)
 {
     (*verticies)[3][0] = 1;
     (*verticies)[3][1] = 1;
@@ -39,7 +43,7 @@ Triangle::Triangle(matrix* verticies, int red, int green, int blue)
 }
 
 Triangle::Triangle(matrix* verticies, unsigned int color)
-:Shape(color)
+:Shape(color), filled(false)
 {
     (*verticies)[3][0] = 1;
     (*verticies)[3][1] = 1;
@@ -60,7 +64,9 @@ Triangle::Triangle(matrix* verticies, unsigned int color)
  *  x2 - x coordinate of thrid point
  *  y2 - y coordinate of third point
  */
-Triangle::Triangle(unsigned int x0, unsigned int y0, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2){
+Triangle::Triangle(unsigned int x0, unsigned int y0, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2)
+:filled(false)
+{
     initTriangleVerticies(x0,y0,x1,y1,x2,y2);
 }
 
@@ -79,11 +85,34 @@ Triangle::Triangle(unsigned int x0, unsigned int y0, unsigned int x1, unsigned i
  *  blue - color value for blue
  */
 Triangle::Triangle(unsigned int x0, unsigned int y0, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2, int red, int green, int blue)
-:Shape(red,green,blue)
+:Shape(red,green,blue), filled(false)
 {    
     initTriangleVerticies(x0,y0,x1,y1,x2,y2);
 }
 
+/* 
+ * This is a constructor for a Triangle object whose storage is carved out of an arena.
+ * 
+ * Parameters:
+ * 	verticies - 3 packed (x, y) pairs in model coordinates
+ *  color - integer color value.
+ *  arena - arena to carve storage from
+ */
+Triangle::Triangle(const double* verticies, unsigned int color, Arena& arena)
+:Shape(color, 3, verticies, arena), filled(false)
+{}
+
+/* 
+ * This is a copy constructor for a Triangle object that carves its storage out of an arena.
+ * 
+ * Parameters:
+ * 	from - reference to Triangle that will be copied.
+ *  arena - arena to carve storage from
+ */
+Triangle::Triangle(const Triangle& from, Arena& arena)
+:Shape(from, arena), filled(from.filled)
+{}
+
 /* 
  * This is a copy constructor for a Triangle object.
  * 
@@ -91,7 +120,7 @@ Triangle::Triangle(unsigned int x0, unsigned int y0, unsigned int x1, unsigned i
  * 	from - reference to Triangle that will be copied.
  */
 Triangle::Triangle(const Triangle& from)
-:Shape(from)
+:Shape(from), filled(from.filled)
 {}
 
 /* 
@@ -112,12 +141,50 @@ Triangle::~Triangle(){}
  *  none
  */
 void Triangle::draw(GraphicsContext* gc, ViewContext* vc){
-    gc->setColor(color->color);
-    matrix* deviceCoord = vc->modelToDevice(this->verticies);
-    gc->drawLine((*deviceCoord)[0][0], (*deviceCoord)[1][0], (*deviceCoord)[0][1], (*deviceCoord)[1][1]);
-    gc->drawLine((*deviceCoord)[0][1], (*deviceCoord)[1][1], (*deviceCoord)[0][2], (*deviceCoord)[1][2]);
-    gc->drawLine((*deviceCoord)[0][2], (*deviceCoord)[1][2], (*deviceCoord)[0][0], (*deviceCoord)[1][0]);
-    delete deviceCoord;
+    PointBlock<3> deviceCoord = vc->modelToDevice(PointBlock<3>(*verticies));
+    double deviceVerticies[6] = {deviceCoord[0].x, deviceCoord[0].y, deviceCoord[1].x, deviceCoord[1].y,
+                                 deviceCoord[2].x, deviceCoord[2].y};
+
+    rasterize(gc, deviceVerticies);
+}
+
+/* 
+ * This method will draw the Triangle object from verticies already in device coordinates
+ * 
+ * Parameters:
+ * 	gc - pointer to graphics context object
+ *  deviceVerticies - 3 packed (x, y) pairs in device coordinates
+ * 
+ * Returns:
+ *  none
+ */
+void Triangle::rasterize(GraphicsContext* gc, const double* deviceVerticies){
+    rasterize(gc, deviceVerticies, color->color, filled);
+}
+
+/* 
+ * Draws a Triangle stored as packed verticies already in device coordinates.
+ * 
+ * Parameters:
+ * 	gc - pointer to graphics context object
+ *  deviceVerticies - 3 packed (x, y) pairs in device coordinates
+ *  color - color of the Triangle
+ *  filled - fill the Triangle rather than drawing its outline
+ * 
+ * Returns:
+ *  none
+ */
+void Triangle::rasterize(GraphicsContext* gc, const double* deviceVerticies, unsigned int color, bool filled){
+    const double* v = deviceVerticies;
+
+    gc->setColor(color);
+    if(filled){
+        gc->fillTriangle(v[0], v[1], v[2], v[3], v[4], v[5]);
+        return;
+    }
+    gc->drawLine(v[0], v[1], v[2], v[3]);
+    gc->drawLine(v[2], v[3], v[4], v[5]);
+    gc->drawLine(v[4], v[5], v[0], v[1]);
 }
 
 /* 
@@ -130,58 +197,130 @@ void Triangle::draw(GraphicsContext* gc, ViewContext* vc){
  *  output stream being passed in
  */
 std::ostream& Triangle::out(std::ostream& os) const{
-    os << "Begin Triangle" << std::endl;
-    os << "Begin Triangle Properties" << std::endl;
-    os << "\tBegin Verticies" << std::endl;
-    os << "\t\tv1: " << (*verticies)[0][0] << "," << (*verticies)[1][0] << std::endl;
-    os << "\t\tv2: " << (*verticies)[0][1] << "," << (*verticies)[1][1] << std::endl;
-    os << "\t\tv3: " << (*verticies)[0][2] << "," << (*verticies)[1][2] << std::endl;
-    os << "\tEnd Verticies" << std::endl;
-    os << "End Triangle Properties" << std::endl;
-    Shape::out(os);
-    os << "End Triangle" << std::endl;
+    double packed[6];
+    packVerticies(packed);
+
+    return write(os, packed, color->color, filled);
+}
+
+/* 
+ * This method will print the properties of the Triangle to a writer
+ * 
+ * Parameters:
+ * 	writer - reference to the writer
+ * 
+ * Returns:
+ *  writer being passed in
+ */
+TextWriter& Triangle::out(TextWriter& writer) const{
+    double packed[6];
+    packVerticies(packed);
+
+    return write(writer, packed, color->color, filled);
+}
+
+/* 
+ * Prints a Triangle stored as packed verticies in the same format as the out method.
+ * 
+ * Parameters:
+ * 	os - reference to the output stream
+ *  verticies - 3 packed (x, y) pairs in model coordinates
+ *  color - color of the Triangle
+ *  filled - whether the Triangle is filled
+ * 
+ * Returns:
+ *  output stream being passed in
+ */
+std::ostream& Triangle::write(std::ostream& os, const double* verticies, unsigned int color, bool filled){
+    TextWriter writer(os);
+    write(writer, verticies, color, filled);
 
     return os;
 }
 
 /* 
- * Reads in a Triangle from file and instantiates and returns the Triangle object
+ * Prints a Triangle stored as packed verticies into a writer, in the same format as the out
+ * method.
  * 
  * Parameters:
- * 	iStream - reference to input file
+ * 	writer - reference to the writer
+ *  verticies - 3 packed (x, y) pairs in model coordinates
+ *  color - color of the Triangle
+ *  filled - whether the Triangle is filled
  * 
  * Returns:
- *  pointer to Triangle object
- */
-Triangle* Triangle::in(std::istream& iStream){
-    std::string v1, v2, v3;
-    Triangle * triangleObj;
-    while(!iStream.eof()){
-        std::string line;
-
-        std::getline(iStream, line);
-
-        if(line.compare("Begin Shape Properties") == 0){
-            triangleObj->Shape::in(iStream);
-        } else if(line.compare("\tBegin Verticies") == 0){
-            std::getline(iStream, v1);
-            std::getline(iStream, v2);
-            std::getline(iStream, v3);
-
-            int x0 = std::stoi(v1.substr(6,v1.find(",")-6));
-            int y0 = std::stoi(v1.substr(v1.find(",")+1,v1.length()));
-            int x1 = std::stoi(v2.substr(6,v2.find(",")-6));
-            int y1 = std::stoi(v2.substr(v2.find(",")+1,v2.length()));
-            int x2 = std::stoi(v3.substr(6,v3.find(",")-6));
-            int y2 = std::stoi(v3.substr(v3.find(",")+1,v3.length()));
-
-
-            triangleObj = new Triangle(x0,y0,x1,y1,x2,y2);
-        } else if(line.compare("End Triangle") == 0){
-            return triangleObj;
-        }
+ *  writer being passed in
+ */
+TextWriter& Triangle::write(TextWriter& writer, const double* verticies, unsigned int color, bool filled){
+    writer << "Begin Triangle\n";
+    writer << "Begin Triangle Properties\n";
+    writer << "\tBegin Verticies\n";
+    writer << "\t\tv1: " << verticies[0] << "," << verticies[1] << "\n";
+    writer << "\t\tv2: " << verticies[2] << "," << verticies[3] << "\n";
+    writer << "\t\tv3: " << verticies[4] << "," << verticies[5] << "\n";
+    writer << "\tEnd Verticies\n";
+    if(filled){
+        // only written for filled triangles, so outlines read the same as before fills existed
+        writer << "\tFill: 1\n";
     }
-    return triangleObj;
+    writer << "End Triangle Properties\n";
+    Shape::writeProperties(writer, verticies, color);
+    writer << "End Triangle\n";
+
+    return writer;
+}
+
+/* 
+ * Returns the kind of the shape.
+ * 
+ * Parameters:
+ * 	none
+ * 
+ * Returns:
+ *  ShapeKind::TRIANGLE
+ */
+ShapeKind Triangle::getKind() const{
+    return ShapeKind::TRIANGLE;
+}
+
+/* 
+ * Returns the flags describing how the Triangle is drawn.
+ * 
+ * Parameters:
+ * 	none
+ * 
+ * Returns:
+ *  SHAPE_FILLED if the Triangle is filled, otherwise 0
+ */
+unsigned char Triangle::getFlags() const{
+    return filled ? SHAPE_FILLED : 0;
+}
+
+/* 
+ * Sets whether the Triangle is filled or only its outline is drawn. Triangles start out
+ * unfilled.
+ * 
+ * Parameters:
+ * 	filled - true to fill the Triangle
+ * 
+ * Returns:
+ *  void
+ */
+void Triangle::setFilled(bool filled){
+    this->filled = filled;
+}
+
+/* 
+ * Returns whether the Triangle is filled.
+ * 
+ * Parameters:
+ * 	none
+ * 
+ * Returns:
+ *  true if the Triangle is filled
+ */
+bool Triangle::isFilled() const{
+    return filled;
 }
 
 /* 
@@ -197,6 +336,20 @@ Shape& Triangle::clone(){
     return *(new Triangle(*this));
 }
 
+/* 
+ * Creates a copy of a Triangle object in an arena. The copy must not be deleted, see
+ * Shape::clone(Arena&).
+ * 
+ * Parameters:
+ * 	arena - arena to place the copy in
+ * 
+ * Returns:
+ *  Triangle object as a shape reference
+ */
+Shape& Triangle::clone(Arena& arena){
+    return *(new (arena) Triangle(*this, arena));
+}
+
 /* 
  * Overrides default = operator for easy assignment of Triangle objects
  * 
@@ -207,8 +360,8 @@ Shape& Triangle::clone(){
  *  reference to Triangle object
  */
 Triangle& Triangle::operator=(const Triangle& from){
-    *verticies = *from.verticies;
     Shape::operator=(from);
+    filled = from.filled;
     return *this;
 }
 
@@ -229,5 +382,5 @@ void Triangle::initTriangleVerticies(unsigned int x0, unsigned int y0, unsigned
     _verticies[3][1] = 1;
     _verticies[3][2] = 1;
 
-    *verticies = _verticies;
+    *verticies = std::move(_verticies);
 }
\ No newline at end of file
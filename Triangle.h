@@ -66,6 +66,25 @@ class Triangle : public Shape{
         */
         Triangle(unsigned int x0, unsigned int y0, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2, int red, int green, int blue);
 
+        /* 
+        * This is a constructor for a Triangle object whose storage is carved out of an arena.
+        * 
+        * Parameters:
+        * 	verticies - 3 packed (x, y) pairs in model coordinates
+        *  color - integer color value.
+        *  arena - arena to carve storage from
+        */
+        Triangle(const double* verticies, unsigned int color, Arena& arena);
+
+        /* 
+        * This is a copy constructor for a Triangle object that carves its storage out of an arena.
+        * 
+        * Parameters:
+        * 	from - reference to Triangle that will be copied.
+        *  arena - arena to carve storage from
+        */
+        Triangle(const Triangle& from, Arena& arena);
+
         /* 
         * This is a copy constructor for a Triangle object.
         * 
@@ -93,6 +112,18 @@ class Triangle : public Shape{
         */
         void draw(GraphicsContext*, ViewContext*);
 
+        /* 
+        * This method will draw the Triangle object from verticies already in device coordinates
+        * 
+        * Parameters:
+        * 	gc - pointer to graphics context object
+        *  deviceVerticies - 3 packed (x, y) pairs in device coordinates
+        * 
+        * Returns:
+        *  none
+        */
+        void rasterize(GraphicsContext* gc, const double* deviceVerticies);
+
         /* 
         * This method will print the properties of the Triangle to an output stream
         * 
@@ -105,15 +136,107 @@ class Triangle : public Shape{
         std::ostream& out(std::ostream& os) const;
 
         /* 
-        * Reads in a Triangle from file and instantiates and returns the Triangle object
+        * This method will print the properties of the Triangle to a writer
+        * 
+        * Parameters:
+        * 	writer - reference to the writer
+        * 
+        * Returns:
+        *  writer being passed in
+        */
+        TextWriter& out(TextWriter& writer) const;
+
+        /* 
+        * Returns the kind of the shape.
+        * 
+        * Parameters:
+        * 	none
+        * 
+        * Returns:
+        *  ShapeKind::TRIANGLE
+        */
+        ShapeKind getKind() const;
+
+        /* 
+        * Returns the flags describing how the Triangle is drawn.
+        * 
+        * Parameters:
+        * 	none
+        * 
+        * Returns:
+        *  SHAPE_FILLED if the Triangle is filled, otherwise 0
+        */
+        unsigned char getFlags() const;
+
+        /* 
+        * Sets whether the Triangle is filled or only its outline is drawn. Triangles start out
+        * unfilled.
         * 
         * Parameters:
-        * 	iStream - reference to input file
+        * 	filled - true to fill the Triangle
         * 
         * Returns:
-        *  pointer to Triangle object
+        *  void
         */
-        static Triangle* in(std::istream& iStream);
+        void setFilled(bool filled);
+
+        /* 
+        * Returns whether the Triangle is filled.
+        * 
+        * Parameters:
+        * 	none
+        * 
+        * Returns:
+        *  true if the Triangle is filled
+        */
+        bool isFilled() const;
+
+        /* 
+        * Draws a Triangle stored as packed verticies already in device coordinates. This is what the
+        * rasterize method uses, and is shared with containers that do not keep Shape objects.
+        * 
+        * Parameters:
+        * 	gc - pointer to graphics context object
+        *  deviceVerticies - 3 packed (x, y) pairs in device coordinates
+        *  color - color of the Triangle
+        *  filled - fill the Triangle rather than drawing its outline
+        * 
+        * Returns:
+        *  none
+        */
+        static void rasterize(GraphicsContext* gc, const double* deviceVerticies, unsigned int color,
+                              bool filled = false);
+
+        /* 
+        * Prints a Triangle stored as packed verticies in the same format as the out method.
+        * 
+        * Parameters:
+        * 	os - reference to the output stream
+        *  verticies - 3 packed (x, y) pairs in model coordinates
+        *  color - color of the Triangle
+        *  filled - whether the Triangle is filled
+        * 
+        * Returns:
+        *  output stream being passed in
+        */
+        static std::ostream& write(std::ostream& os, const double* verticies, unsigned int color,
+                                   bool filled = false);
+
+        /* 
+        * Prints a Triangle stored as packed verticies into a writer, in the same format as the
+        * out method.
+        * 
+        * Parameters:
+        * 	writer - reference to the writer
+        *  verticies - 3 packed (x, y) pairs in model coordinates
+        *  color - color of the Triangle
+        *  filled - whether the Triangle is filled
+        * 
+        * Returns:
+        *  writer being passed in
+        */
+        static TextWriter& write(TextWriter& writer, const double* verticies, unsigned int color,
+                                 bool filled = false);
 
         /* 
         * Creates a copy of a Triangle object, but returns a refernce to the Triangle as a shape reference
@@ -126,6 +249,18 @@ class Triangle : public Shape{
         */
         Shape& clone();
 
+        /* 
+        * Creates a copy of a Triangle object in an arena. The copy must not be deleted, see
+        * Shape::clone(Arena&).
+        * 
+        * Parameters:
+        * 	arena - arena to place the copy in
+        * 
+        * Returns:
+        *  Triangle object as a shape reference
+        */
+        Shape& clone(Arena& arena);
+
         /* 
         * Overrides default = operator for easy assignment of Triangle objects
         * 
@@ -138,6 +273,8 @@ class Triangle : public Shape{
         Triangle& operator=(const Triangle& from);
 
     private:
+        bool filled;
+
         /* 
         * Helper function for initializing verticies
         */
@@ -17,25 +17,15 @@
  * Outputs:
  *      Pointer to ViewContext Object
  */
-ViewContext::ViewContext(int x, int y, int z){
-    toModelCoordinates = new matrix(4,4);
-    toDeviceCoordinates = new matrix(4,4);
-    translateToOrigin = new matrix(4,4);
-    translateFromOrigin = new matrix(4,4);
-
-    for(int i = 0; i < 4; i++){
-        (*toModelCoordinates)[i][i] = 1.0;
-        (*toDeviceCoordinates)[i][i] = 1.0;
-        (*translateToOrigin)[i][i] = 1.0;
-        (*translateFromOrigin)[i][i] = 1.0;
-    }
-
-    (*translateToOrigin)[0][3] = -x;
-    (*translateToOrigin)[1][3] = -y;
-    (*translateFromOrigin)[0][3] = x;
-    (*translateFromOrigin)[1][3] = y;
+ViewContext::ViewContext(int x, int y, int z)
+:originX(x), originY(y)
+{
+    reset();
 }
 
+// generations are handed out program wide, so no two views ever share one
+unsigned long ViewContext::nextGeneration = 0;
+
 /* 
  * This function handles destroying the ViewContext object, with its underyling data structures.
  * Inputs:
@@ -43,12 +33,7 @@ ViewContext::ViewContext(int x, int y, int z){
  * Outputs:
  *      none
  */
-ViewContext::~ViewContext(){
-    delete toModelCoordinates;
-    delete toDeviceCoordinates;
-    delete translateToOrigin;
-    delete translateFromOrigin;
-}
+ViewContext::~ViewContext(){}
 
 /* 
  * This function converts the device coordinates observed on the screen into model coordinates. Essentially,
@@ -61,11 +46,7 @@ ViewContext::~ViewContext(){
  *      matrix* - pointer to transformed matrix object
  */
 matrix* ViewContext::deviceToModel(matrix* shapeVerticies){
-    matrix* deviceCoordinates = new matrix(4,3);
-
-    *deviceCoordinates = (*toModelCoordinates * *shapeVerticies);
-
-    return deviceCoordinates;
+    return transform(toModelCoordinates, *shapeVerticies);
 }
 
 /* 
@@ -78,11 +59,42 @@ matrix* ViewContext::deviceToModel(matrix* shapeVerticies){
  *      matrix* - pointer to transformed matrix object
  */
 matrix* ViewContext::modelToDevice(matrix* shapeVerticies){
-    matrix* deviceCoordinates = new matrix(4,3);
+    return transform(toDeviceCoordinates, *shapeVerticies);
+}
 
-    *deviceCoordinates = (*toDeviceCoordinates * *shapeVerticies);
+/* 
+ * Converts an array of packed (x, y) model coordinates into device coordinates using the
+ * fastest transform kernel available on this machine. in and out may be the same array.
+ * 
+ * Inputs:
+ *      in - count (x, y) pairs in model coordinates
+ *      out - storage for count (x, y) pairs in device coordinates
+ *      count - number of points
+ * Outputs:
+ *      none
+ */
+void ViewContext::transformPoints(const double* in, double* out, std::size_t count) const{
+    ::transformPoints(toDeviceCoordinates, in, out, count);
+}
 
-    return deviceCoordinates;
+void ViewContext::transformPoints(const float* in, float* out, std::size_t count) const{
+    ::transformPoints(toDeviceCoordinates, in, out, count);
+}
+
+/* 
+ * Converts a whole buffer of packed (x, y) model coordinates into device coordinates in
+ * one pass. The device buffer is resized to match and is intended to be reused between
+ * frames, so after the first call no memory is allocated.
+ * 
+ * Inputs:
+ *      modelVerticies - packed (x, y) pairs in model coordinates
+ *      deviceVerticies - buffer that receives the packed device coordinates
+ * Outputs:
+ *      none
+ */
+void ViewContext::modelToDeviceBatch(const std::vector<double>& modelVerticies, std::vector<double>& deviceVerticies) const{
+    deviceVerticies.resize(modelVerticies.size());
+    transformPoints(modelVerticies.data(), deviceVerticies.data(), modelVerticies.size() / 2);
 }
 
 /* 
@@ -96,21 +108,7 @@ matrix* ViewContext::modelToDevice(matrix* shapeVerticies){
  *      none
  */
 void ViewContext::scale(double a, double b){
-    matrix scale(4,4);
-    matrix undoScale(4,4);
-
-    scale[0][0] = a;
-    scale[1][1] = b;
-    scale[2][2] = 1;
-    scale[3][3] = 1;
-
-    undoScale[0][0] = 1/a;
-    undoScale[1][1] = 1/b;
-    undoScale[2][2] = 1;
-    undoScale[3][3] = 1;
-
-    *toDeviceCoordinates = *translateFromOrigin * scale * *translateToOrigin * *toDeviceCoordinates;
-    *toModelCoordinates = *toModelCoordinates * *translateFromOrigin * undoScale * *translateToOrigin;
+    apply(a, 0, 0, b, 0, 0);
 }
 
 /* 
@@ -123,27 +121,11 @@ void ViewContext::scale(double a, double b){
  *      none
  */
 void ViewContext::rotate(double theta_deg){
-    matrix rotate(4,4);
-    matrix undoRotate(4,4);
-
     double theta = theta_deg * (PI/180.0);
+    double cosTheta = std::cos(theta);
+    double sinTheta = std::sin(theta);
 
-    rotate[0][0] = std::cos(theta);
-    rotate[0][1] = -1 * std::sin(theta);
-    rotate[1][0] = std::sin(theta);
-    rotate[1][1] = std::cos(theta);
-    rotate[2][2] = 1;
-    rotate[3][3] = 1;
-
-    undoRotate[0][0] = std::cos(-theta);
-    undoRotate[0][1] = -1 * std::sin(-theta);
-    undoRotate[1][0] = std::sin(-theta);
-    undoRotate[1][1] = std::cos(-theta);
-    undoRotate[2][2] = 1;
-    undoRotate[3][3] = 1;
-
-    *toDeviceCoordinates = (*translateFromOrigin * rotate * *translateToOrigin * *toDeviceCoordinates);
-    *toModelCoordinates = (*toModelCoordinates * *translateFromOrigin * undoRotate * *translateToOrigin);  
+    apply(cosTheta, -sinTheta, sinTheta, cosTheta, 0, 0);
 }
 
 /* 
@@ -157,17 +139,7 @@ void ViewContext::rotate(double theta_deg){
  *      none
  */
 void ViewContext::translate(int x, int y){
-    matrix translate = matrix::identity(4);
-    matrix undoTranslate = matrix::identity(4);
-
-    translate[0][3] = x;
-    translate[1][3] = y;
-
-    undoTranslate[0][3] = -x;
-    undoTranslate[1][3] = -y;
-
-    *toDeviceCoordinates = (*translateFromOrigin * translate * *translateToOrigin * *toDeviceCoordinates);
-    *toModelCoordinates = (*toModelCoordinates * *translateFromOrigin * undoTranslate * *translateToOrigin);
+    apply(1, 0, 0, 1, x, y);
 }
 
 /* 
@@ -179,12 +151,121 @@ void ViewContext::translate(int x, int y){
  *      none
  */
 void ViewContext::reset(){
-    for(int i = 0; i < 4; i++){
-        for(int j = 0; j < 4; j++){
-            (*toModelCoordinates)[i][j] = 0.0;
-            (*toDeviceCoordinates)[i][j] = 0.0;
-        }
-        (*toModelCoordinates)[i][i] = 1.0;
-        (*toDeviceCoordinates)[i][i] = 1.0;
+    const Affine identity = {1, 0, 0,
+                             0, 1, 0};
+
+    modelToDeviceAffine = identity;
+    deviceToModelAffine = identity;
+    toModelCoordinates = Mat4::identity();
+    toDeviceCoordinates = Mat4::identity();
+    generation = ++nextGeneration;
+}
+
+/* 
+ * Returns a number identifying the current view. It changes whenever the view is scaled,
+ * rotated, translated or reset, and no two ViewContext objects ever share one.
+ * 
+ * Inputs:
+ *      none
+ * Outputs:
+ *      generation of the view
+ */
+unsigned long ViewContext::getGeneration() const{
+    return generation;
+}
+
+/* 
+ * Helper that applies a change to the view. The change maps a device point p to
+ * L*(p - origin) + origin + (x, y), where L is the 2x2 matrix [a b; d e]. The forward transform
+ * is composed with the change and the inverse with the undone change, so neither is ever
+ * inverted numerically.
+ * 
+ * Inputs:
+ *      a, b, d, e - linear part of the change, which must be invertible
+ *      x, y - translation applied after it
+ * Outputs:
+ *      none
+ */
+void ViewContext::apply(double a, double b, double d, double e, double x, double y){
+    Affine change = {a, b, originX - a * originX - b * originY + x,
+                     d, e, originY - d * originX - e * originY + y};
+
+    // L^-1 * (p - origin - (x, y)) + origin
+    double determinant = a * e - b * d;
+    double ia = e / determinant;
+    double ib = -b / determinant;
+    double id = -d / determinant;
+    double ie = a / determinant;
+    double shiftX = originX + x;
+    double shiftY = originY + y;
+    Affine undo = {ia, ib, originX - ia * shiftX - ib * shiftY,
+                   id, ie, originY - id * shiftX - ie * shiftY};
+
+    modelToDeviceAffine = compose(change, modelToDeviceAffine);
+    deviceToModelAffine = compose(deviceToModelAffine, undo);
+    toDeviceCoordinates = toMat4(modelToDeviceAffine);
+    toModelCoordinates = toMat4(deviceToModelAffine);
+    generation = ++nextGeneration;
+}
+
+/* 
+ * Helper that composes two affine transforms.
+ * 
+ * Inputs:
+ *      second - transform applied last
+ *      first - transform applied first
+ * Outputs:
+ *      Affine - the transform applying first, then second
+ */
+ViewContext::Affine ViewContext::compose(const Affine& second, const Affine& first){
+    Affine result = {second.a * first.a + second.b * first.d,
+                     second.a * first.b + second.b * first.e,
+                     second.a * first.c + second.b * first.f + second.c,
+                     second.d * first.a + second.e * first.d,
+                     second.d * first.b + second.e * first.e,
+                     second.d * first.c + second.e * first.f + second.f};
+    return result;
+}
+
+/* 
+ * Helper that widens an affine transform to a 4x4 matrix, leaving z and w untouched.
+ * 
+ * Inputs:
+ *      affine - transform to widen
+ * Outputs:
+ *      Mat4 - the same transform as a matrix
+ */
+Mat4 ViewContext::toMat4(const Affine& affine){
+    Mat4 result = Mat4::identity();
+    result(0, 0) = affine.a;
+    result(0, 1) = affine.b;
+    result(0, 3) = affine.c;
+    result(1, 0) = affine.d;
+    result(1, 1) = affine.e;
+    result(1, 3) = affine.f;
+    return result;
+}
+
+/* 
+ * Helper that applies a transform to every column of a matrix, returning the result as
+ * a new matrix of the same size.
+ * 
+ * Inputs:
+ *      m - transform to apply
+ *      shapeVerticies - matrix containing the verticies of the shape.
+ * Outputs:
+ *      matrix* - pointer to transformed matrix object
+ */
+matrix* ViewContext::transform(const Mat4& m, const matrix& shapeVerticies){
+    matrix* result = new matrix(4, shapeVerticies.getCols());
+
+    for(unsigned int i = 0; i < shapeVerticies.getCols(); i++){
+        Vec4 v = m * Vec4(shapeVerticies[0][i], shapeVerticies[1][i], shapeVerticies[2][i], shapeVerticies[3][i]);
+        (*result)[0][i] = v.x;
+        (*result)[1][i] = v.y;
+        (*result)[2][i] = v.z;
+        (*result)[3][i] = v.w;
     }
+
+    return result;
 }
@@ -9,8 +9,11 @@
 #define VIEWCONTEXT_H
 
 #include <cmath>
+#include <cstddef>
+#include <vector>
 
 #include "matrix.h"
+#include "transform.h"
 #include "Shape.h"
 
 #define PI 3.14159265359
@@ -64,6 +67,55 @@ class ViewContext {
         */
         matrix* modelToDevice(matrix*);
 
+        /* 
+        * Allocation free version of deviceToModel for a fixed number of verticies.
+        * 
+        * Inputs:
+        *      shapeVerticies - block containing the verticies of the shape.
+        * Outputs:
+        *      PointBlock - transformed verticies
+        */
+        template <unsigned int N>
+        PointBlock<N> deviceToModel(const PointBlock<N>& shapeVerticies) const;
+
+        /* 
+        * Allocation free version of modelToDevice for a fixed number of verticies.
+        * 
+        * Inputs:
+        *      shapeVerticies - block containing the verticies of the shape.
+        * Outputs:
+        *      PointBlock - transformed verticies
+        */
+        template <unsigned int N>
+        PointBlock<N> modelToDevice(const PointBlock<N>& shapeVerticies) const;
+
+        /* 
+        * Converts an array of packed (x, y) model coordinates into device coordinates using the
+        * fastest transform kernel available on this machine. in and out may be the same array.
+        * 
+        * Inputs:
+        *      in - count (x, y) pairs in model coordinates
+        *      out - storage for count (x, y) pairs in device coordinates
+        *      count - number of points
+        * Outputs:
+        *      none
+        */
+        void transformPoints(const double* in, double* out, std::size_t count) const;
+        void transformPoints(const float* in, float* out, std::size_t count) const;
+
+        /* 
+        * Converts a whole buffer of packed (x, y) model coordinates into device coordinates in
+        * one pass. The device buffer is resized to match and is intended to be reused between
+        * frames, so after the first call no memory is allocated.
+        * 
+        * Inputs:
+        *      modelVerticies - packed (x, y) pairs in model coordinates
+        *      deviceVerticies - buffer that receives the packed device coordinates
+        * Outputs:
+        *      none
+        */
+        void modelToDeviceBatch(const std::vector<double>& modelVerticies, std::vector<double>& deviceVerticies) const;
+
         /* 
         * This function applies a scale to the exisiting transformation matrix, while simultaneously updating the 
         * inverse transformation matrix.
@@ -109,12 +161,72 @@ class ViewContext {
         */
         void reset();
 
+        /* 
+        * Returns a number identifying the current view. It changes whenever the view is scaled,
+        * rotated, translated or reset, and no two ViewContext objects ever share one, so results
+        * computed for a view can be kept until the generation changes.
+        * 
+        * Inputs:
+        *      none
+        * Outputs:
+        *      generation of the view
+        */
+        unsigned long getGeneration() const;
+
     private:
-        matrix* toModelCoordinates;
-        matrix* toDeviceCoordinates;
+        // A 2D affine transform taking (x, y) to (a*x + b*y + c, d*x + e*y + f)
+        struct Affine{
+            double a, b, c;
+            double d, e, f;
+        };
+
+        // The view in both directions. Changes are composed into these directly.
+        Affine modelToDeviceAffine;
+        Affine deviceToModelAffine;
+
+        // The same transforms in the form the transform kernels and PointBlocks take
+        Mat4 toModelCoordinates;
+        Mat4 toDeviceCoordinates;
 
-        matrix* translateToOrigin;
-        matrix* translateFromOrigin;
+        // point that scaling and rotation happen around
+        double originX;
+        double originY;
+
+        unsigned long generation;
+        static unsigned long nextGeneration;
+
+        /* 
+        * Helper that applies a linear change around the origin followed by a translation to the
+        * view, updating both directions and the generation.
+        */
+        void apply(double a, double b, double d, double e, double x, double y);
+
+        /* 
+        * Helper that composes two affine transforms, returning the transform that applies
+        * second after first.
+        */
+        static Affine compose(const Affine& second, const Affine& first);
+
+        /* 
+        * Helper that widens an affine transform to a 4x4 matrix.
+        */
+        static Mat4 toMat4(const Affine& affine);
+
+        /* 
+        * Helper that applies a transform to every column of a matrix, returning the result as
+        * a new matrix of the same size.
+        */
+        static matrix* transform(const Mat4& m, const matrix& shapeVerticies);
 };
 
+template <unsigned int N>
+PointBlock<N> ViewContext::deviceToModel(const PointBlock<N>& shapeVerticies) const {
+    return toModelCoordinates * shapeVerticies;
+}
+
+template <unsigned int N>
+PointBlock<N> ViewContext::modelToDevice(const PointBlock<N>& shapeVerticies) const {
+    return toDeviceCoordinates * shapeVerticies;
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,115 @@
+/**
+ * arena_bench.cpp - Counts the heap allocations made while loading and
+ * erasing a large drawing, comparing individually allocated shapes with
+ * the arena backed SHAPES image and the PACKED image.
+ *
+ * Build with 'make bench' and run ./bench/arena_bench [shapes]
+ */
+
+#include "Image.h"
+#include "Shape.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// every heap allocation in the program goes through here
+static unsigned long heapAllocations = 0;
+
+void* operator new(size_t size){
+    heapAllocations++;
+    if(void* memory = malloc(size ? size : 1)) return memory;
+    throw bad_alloc();
+}
+
+void operator delete(void* memory) noexcept{
+    free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept{
+    free(memory);
+}
+
+static string makeDrawing(size_t shapes);
+static void report(const char* name, unsigned long allocations, double seconds, size_t shapes);
+
+int main(int argc, char** argv){
+    size_t shapes = argc > 1 ? strtoul(argv[1], NULL, 10) : 200000;
+    string text = makeDrawing(shapes);
+
+    cout << shapes << " shapes, " << text.size() / 1024 << " KiB of text" << endl;
+
+    {
+        istringstream in(text);
+        unsigned long before = heapAllocations;
+        auto start = chrono::steady_clock::now();
+
+        // every shape copied out of a packed image is a Line or Triangle of its own
+        Image* image = Image::in(in, Image::Storage::PACKED);
+        vector<Shape*> loaded;
+        for(unsigned int i = 0; i < image->size(); i++){
+            loaded.push_back(image->getShape(i));
+        }
+        delete image;
+        for(vector<Shape*>::const_iterator iter(loaded.begin()); iter != loaded.end(); ++iter){
+            delete *iter;
+        }
+
+        report("new/delete per shape", heapAllocations - before,
+               chrono::duration<double>(chrono::steady_clock::now() - start).count(), loaded.size());
+    }
+
+    const Image::Storage storages[] = {Image::Storage::SHAPES, Image::Storage::PACKED};
+    const char* names[] = {"Image SHAPES (arena)", "Image PACKED"};
+    for(int i = 0; i < 2; i++){
+        istringstream in(text);
+        unsigned long before = heapAllocations;
+        auto start = chrono::steady_clock::now();
+
+        Image* image = Image::in(in, storages[i]);
+        size_t loaded = image->size();
+        Arena::Stats stats = image->getAllocationStats();
+        delete image;
+
+        report(names[i], heapAllocations - before,
+               chrono::duration<double>(chrono::steady_clock::now() - start).count(), loaded);
+        if(storages[i] == Image::Storage::SHAPES){
+            cout << "    arena: " << stats.allocations << " allocations from " << stats.blocks
+                 << " blocks, " << stats.bytes / 1024 << " KiB" << endl;
+        }
+    }
+
+    return 0;
+}
+
+/*
+ * Writes a drawing of random lines and triangles in the text format.
+ */
+static string makeDrawing(size_t shapes){
+    Image image(Image::Storage::PACKED);
+    for(size_t s = 0; s < shapes; s++){
+        double verticies[6];
+        for(int v = 0; v < 6; v++){
+            verticies[v] = rand() % 800;
+        }
+        image.add(s % 2 ? ShapeKind::TRIANGLE : ShapeKind::LINE, rand() & 0xFFFFFF, verticies);
+    }
+
+    ostringstream out;
+    image.out(out);
+    return out.str();
+}
+
+static void report(const char* name, unsigned long allocations, double seconds, size_t shapes){
+    cout << left << setw(24) << name << right << setw(10) << shapes << " shapes"
+         << setw(12) << allocations << " heap allocations" << setw(8) << fixed << setprecision(2)
+         << (double)allocations / shapes << " per shape" << setw(10) << setprecision(1)
+         << seconds * 1e3 << " ms" << endl;
+}
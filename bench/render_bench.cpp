@@ -0,0 +1,95 @@
+/**
+ * render_bench.cpp - Times Image::draw of a random drawing into an
+ * 800x600 MemoryContext, so the rasterization path can be measured
+ * without an X server.  Repeated frames of one view reuse the cached
+ * device coordinates, so a run that pans the view every frame is timed
+ * as well, and so is adding a small shape and updating the window with
+ * drawDirty.  A last run zooms in 8x, where most shapes are off screen
+ * and culled.
+ *
+ * Build with 'make bench' and run ./bench/render_bench [shapes]
+ */
+
+#include "Image.h"
+#include "ViewContext.h"
+#include "memorycontext.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+
+using namespace std;
+
+static const int repeats = 10;
+
+static double bestFrame(Image& image, MemoryContext& gc, ViewContext& vc, bool pan = false);
+
+int main(int argc, char** argv){
+    size_t shapes = argc > 1 ? strtoul(argv[1], NULL, 10) : 20000;
+
+    MemoryContext gc(800, 600, GraphicsContext::BLACK);
+    ViewContext vc(gc.getWindowWidth()/2, gc.getWindowHeight()/2, 0);
+
+    Image image(Image::Storage::PACKED);
+    for(size_t s = 0; s < shapes; s++){
+        double verticies[6];
+        for(int v = 0; v < 6; v += 2){
+            verticies[v] = rand() % 800;
+            verticies[v+1] = rand() % 600;
+        }
+        image.add(s % 2 ? ShapeKind::TRIANGLE : ShapeKind::LINE, rand() & 0xFFFFFF, verticies);
+    }
+
+    double best = bestFrame(image, gc, vc);
+
+    // a checksum of the framebuffer, so changes to the rasterizers can be compared
+    unsigned long checksum = 0;
+    const unsigned int* pixels = gc.getPixels();
+    for(int i = 0; i < gc.getWindowWidth() * gc.getWindowHeight(); i++){
+        checksum = checksum * 31 + pixels[i];
+    }
+
+    cout << shapes << " shapes, best of " << repeats << " frames: " << fixed << setprecision(2)
+         << best * 1e3 << " ms/frame, " << setprecision(1) << 1 / best << " frames/s" << endl;
+    cout << "framebuffer checksum: " << hex << checksum << dec << endl;
+
+    double panned = bestFrame(image, gc, vc, true);
+    cout << "panning every frame: " << fixed << setprecision(2) << panned * 1e3 << " ms/frame, "
+         << setprecision(1) << 1 / panned << " frames/s" << endl;
+
+    // adding a shape the way MyDrawing does, redrawing only its area
+    image.draw(&gc, &vc);
+    double added = 1e30;
+    for(int r = 0; r < repeats; r++){
+        double verticies[6] = {390.0 + r, 290, 410, 300, 400, 310.0 + r};
+        auto start = chrono::steady_clock::now();
+        image.add(ShapeKind::TRIANGLE, GraphicsContext::WHITE, verticies);
+        image.drawDirty(&gc, &vc);
+        added = min(added, chrono::duration<double>(chrono::steady_clock::now() - start).count());
+    }
+    cout << "add + drawDirty: " << fixed << setprecision(3) << added * 1e3 << " ms" << endl;
+
+    vc.reset();
+    vc.scale(8, 8);
+    double zoomed = bestFrame(image, gc, vc);
+    cout << "zoomed 8x: " << fixed << setprecision(2) << zoomed * 1e3 << " ms/frame, "
+         << setprecision(1) << 1 / zoomed << " frames/s" << endl;
+
+    return 0;
+}
+
+/*
+ * Draws the image repeatedly and returns the fastest frame in seconds. With pan the view
+ * moves back and forth by a pixel before each frame.
+ */
+static double bestFrame(Image& image, MemoryContext& gc, ViewContext& vc, bool pan){
+    double best = 1e30;
+    for(int r = 0; r < repeats; r++){
+        auto start = chrono::steady_clock::now();
+        if(pan) vc.translate(r % 2 ? -1 : 1, 0);
+        image.draw(&gc, &vc);
+        best = min(best, chrono::duration<double>(chrono::steady_clock::now() - start).count());
+    }
+    return best;
+}
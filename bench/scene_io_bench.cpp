@@ -0,0 +1,111 @@
+/**
+ * scene_io_bench.cpp - Times saving and loading a random drawing in the
+ * text format of Image::out/Image::in and the binary format of
+ * Image::writeBinary/Image::readBinary.  The files are written to and
+ * read from memory, so only the formatting and parsing are measured.
+ * Opening the binary file with Image::mapBinary is timed from a
+ * temporary file, which is likely still in the page cache.
+ *
+ * Build with 'make bench' and run ./bench/scene_io_bench [shapes]
+ */
+
+#include "Image.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+using namespace std;
+
+static double seconds(chrono::steady_clock::time_point start);
+static void report(const char* what, size_t bytes, double save, double load);
+
+int main(int argc, char** argv){
+    size_t shapes = argc > 1 ? strtoul(argv[1], NULL, 10) : 200000;
+
+    Image image(Image::Storage::PACKED);
+    for(size_t s = 0; s < shapes; s++){
+        double verticies[6];
+        for(int v = 0; v < 6; v++){
+            verticies[v] = (rand() % 80000) / 100.0;
+        }
+        image.add(s % 2 ? ShapeKind::TRIANGLE : ShapeKind::LINE, rand() & 0xFFFFFF, verticies);
+    }
+
+    auto start = chrono::steady_clock::now();
+    ostringstream text;
+    image.out(text);
+    double textSave = seconds(start);
+
+    string textFile = text.str();
+    start = chrono::steady_clock::now();
+    istringstream textIn(textFile);
+    Image* fromText = Image::in(textIn, Image::Storage::PACKED);
+    double textLoad = seconds(start);
+
+    start = chrono::steady_clock::now();
+    ostringstream binary;
+    image.writeBinary(binary);
+    double binarySave = seconds(start);
+
+    string binaryFile = binary.str();
+    start = chrono::steady_clock::now();
+    istringstream binaryIn(binaryFile);
+    Image* fromBinary = Image::readBinary(binaryIn, Image::Storage::PACKED);
+    double binaryLoad = seconds(start);
+
+    string filename = "scene_io_bench.tmp";
+    ofstream binaryOut(filename, ios::binary);
+    binaryOut << binaryFile;
+    binaryOut.close();
+
+    start = chrono::steady_clock::now();
+    Image* mapped = Image::mapBinary(filename);
+    double mapLoad = seconds(start);
+
+    cout << shapes << " shapes" << endl;
+    report("text", textFile.size(), textSave, textLoad);
+    report("binary", binaryFile.size(), binarySave, binaryLoad);
+    cout << " mapped: open " << fixed << setprecision(1) << mapLoad * 1e3 << " ms" << endl;
+
+    // the binary format keeps the verticies exactly, the text one to 6 significant digits
+    bool matches = fromText != NULL && fromText->size() == shapes;
+    for(Image* loaded : {fromBinary, mapped}){
+        matches = matches && loaded != NULL && loaded->getPointCount() == image.getPointCount() &&
+                  equal(image.getVerticies(), image.getVerticies() + 2 * image.getPointCount(),
+                        loaded->getVerticies());
+    }
+
+    delete fromText;
+    delete fromBinary;
+    delete mapped;
+    remove(filename.c_str());
+
+    if(!matches){
+        cout << "loaded images do not match" << endl;
+        return 1;
+    }
+    return 0;
+}
+
+/*
+ * Returns the seconds since start.
+ */
+static double seconds(chrono::steady_clock::time_point start){
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+/*
+ * Prints the size of a file and how long it took to save and load.
+ */
+static void report(const char* what, size_t bytes, double save, double load){
+    cout << setw(7) << what << ": " << fixed << setprecision(1) << setw(7) << bytes / 1e6 << " MB, save "
+         << setprecision(1) << setw(7) << save * 1e3 << " ms, load " << setw(7) << load * 1e3 << " ms ("
+         << setprecision(0) << bytes / 1e6 / load << " MB/s)" << endl;
+}
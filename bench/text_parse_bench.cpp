@@ -0,0 +1,179 @@
+/**
+ * text_parse_bench.cpp - Times parsing a random drawing in the text format
+ * with the line by line stream parser Image::in used to have, copied here
+ * as the baseline, against Image::parse over the whole file
+ * on one thread and on as many as asked for, and Image::in, which reads the
+ * stream into a buffer for Image::parse.  The file is parsed from memory, so
+ * only the parsing is measured.
+ *
+ * Build with 'make bench' and run ./bench/text_parse_bench [shapes] [threads]
+ */
+
+#include "Image.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <thread>
+
+using namespace std;
+
+static Image* streamParse(istream& iStream);
+static bool streamRead(istream& iStream, unsigned int count, const string& end, double* verticies,
+                       unsigned int& color, bool& filled);
+static double seconds(chrono::steady_clock::time_point start);
+static void report(const char* what, size_t bytes, double load, double baseline);
+
+int main(int argc, char** argv){
+    size_t shapes = argc > 1 ? strtoul(argv[1], NULL, 10) : 200000;
+    unsigned int threads = argc > 2 ? strtoul(argv[2], NULL, 10) : thread::hardware_concurrency();
+
+    Image image(Image::Storage::PACKED);
+    for(size_t s = 0; s < shapes; s++){
+        double verticies[6];
+        for(int v = 0; v < 6; v++){
+            verticies[v] = (rand() % 80000) / 100.0;
+        }
+        image.add(s % 2 ? ShapeKind::TRIANGLE : ShapeKind::LINE, rand() & 0xFFFFFF, verticies,
+                  s % 4 == 1 ? SHAPE_FILLED : 0);
+    }
+    ostringstream text;
+    image.out(text);
+    string textFile = text.str();
+
+    auto start = chrono::steady_clock::now();
+    istringstream streamIn(textFile);
+    Image* fromStream = streamParse(streamIn);
+    double streamLoad = seconds(start);
+
+    start = chrono::steady_clock::now();
+    Image* parsed = Image::parse(textFile, Image::Storage::PACKED, 1);
+    double parseLoad = seconds(start);
+
+    start = chrono::steady_clock::now();
+    Image* chunked = Image::parse(textFile, Image::Storage::PACKED, threads);
+    double chunkedLoad = seconds(start);
+
+    start = chrono::steady_clock::now();
+    istringstream textIn(textFile);
+    Image* fromText = Image::in(textIn, Image::Storage::PACKED);
+    double inLoad = seconds(start);
+
+    cout << shapes << " shapes, " << fixed << setprecision(1) << textFile.size() / 1e6 << " MB" << endl;
+    report("stream", textFile.size(), streamLoad, streamLoad);
+    report("parse", textFile.size(), parseLoad, streamLoad);
+    cout << threads << " threads" << endl;
+    report("parse", textFile.size(), chunkedLoad, streamLoad);
+    report("in", textFile.size(), inLoad, streamLoad);
+
+    // all of them have to read back the same drawing
+    ostringstream expected;
+    fromStream->out(expected);
+    bool matches = true;
+    for(Image* loaded : {parsed, chunked, fromText}){
+        ostringstream actual;
+        loaded->out(actual);
+        matches = matches && actual.str() == expected.str();
+    }
+
+    delete fromStream;
+    delete parsed;
+    delete chunked;
+    delete fromText;
+
+    if(!matches){
+        cout << "parsed images do not match" << endl;
+        return 1;
+    }
+    return 0;
+}
+
+/*
+ * The stream parser Image::in used to have, reading a line at a time and handing
+ * each record to streamRead.
+ */
+static Image* streamParse(istream& iStream){
+    Image* image = NULL;
+    while(!iStream.eof()){
+        string line;
+        getline(iStream, line);
+        if(line.find("Begin Image") != string::npos){
+            image = new Image(Image::Storage::PACKED);
+            while(!iStream.eof()){
+                double verticies[6];
+                unsigned int color = GraphicsContext::WHITE;
+                bool filled = false;
+                getline(iStream, line);
+                if(line.find("Begin Line") != string::npos){
+                    if(streamRead(iStream, 2, "End Line", verticies, color, filled)){
+                        image->add(ShapeKind::LINE, color, verticies);
+                    }
+                }else if(line.find("Begin Triangle") != string::npos){
+                    if(streamRead(iStream, 3, "End Triangle", verticies, color, filled)){
+                        image->add(ShapeKind::TRIANGLE, color, verticies, filled ? SHAPE_FILLED : 0);
+                    }
+                }else if(line.find("End Shapes") != string::npos){
+                    break;
+                }
+            }
+        }else if(line.find("End Image") != string::npos){
+            return image;
+        }
+    }
+    return image;
+}
+
+/*
+ * The rest of a Line or Triangle record as Line::read and Triangle::read used to read it,
+ * with std::getline and std::stoi, shape properties section included.
+ */
+static bool streamRead(istream& iStream, unsigned int count, const string& end, double* verticies,
+                       unsigned int& color, bool& filled){
+    string v[3];
+    bool found = false;
+    while(!iStream.eof()){
+        string line;
+        getline(iStream, line);
+        if(line.compare("Begin Shape Properties") == 0){
+            while(!iStream.eof()){
+                getline(iStream, line);
+                if(line.find("Color:") != string::npos){
+                    color = stoi(line.substr(8, line.length()));
+                }else if(line.find("End Shape Properties") != string::npos){
+                    break;
+                }
+            }
+        }else if(line.compare("\tBegin Verticies") == 0){
+            for(unsigned int i = 0; i < count; i++){
+                getline(iStream, v[i]);
+                verticies[2*i] = stoi(v[i].substr(6, v[i].find(",") - 6));
+                verticies[2*i+1] = stoi(v[i].substr(v[i].find(",") + 1, v[i].length()));
+            }
+            found = true;
+        }else if(count == 3 && line.compare(0, 7, "\tFill: ") == 0){
+            filled = stoi(line.substr(7)) != 0;
+        }else if(line.compare(end) == 0){
+            return found;
+        }
+    }
+    return found;
+}
+
+/*
+ * Returns the seconds since start.
+ */
+static double seconds(chrono::steady_clock::time_point start){
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+/*
+ * Prints how long a parser took, its throughput and its speedup over the baseline.
+ */
+static void report(const char* what, size_t bytes, double load, double baseline){
+    cout << setw(7) << what << ": " << fixed << setprecision(1) << setw(7) << load * 1e3 << " ms ("
+         << setprecision(0) << setw(4) << bytes / 1e6 / load << " MB/s, " << setprecision(2)
+         << baseline / load << "x)" << endl;
+}
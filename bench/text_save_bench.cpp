@@ -0,0 +1,151 @@
+/**
+ * text_save_bench.cpp - Times saving a random drawing in the text format to
+ * a file with the stream writer Image::out used to have, which ends every
+ * line with std::endl and so flushes the file once per line, against
+ * Image::out, which formats into a TextWriter buffer.  Both files have to
+ * come out the same.
+ *
+ * Build with 'make bench' and run ./bench/text_save_bench [shapes]
+ */
+
+#include "Image.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+using namespace std;
+
+static void streamWrite(ostream& os, const Image& image);
+static void streamWriteProperties(ostream& os, const double* verticies, unsigned int color);
+static string contents(const string& filename);
+static double seconds(chrono::steady_clock::time_point start);
+static void report(const char* what, size_t bytes, double save, double baseline);
+
+int main(int argc, char** argv){
+    size_t shapes = argc > 1 ? strtoul(argv[1], NULL, 10) : 1000000;
+
+    Image image(Image::Storage::PACKED);
+    for(size_t s = 0; s < shapes; s++){
+        double verticies[6];
+        for(int v = 0; v < 6; v++){
+            verticies[v] = (rand() % 80000) / 100.0;
+        }
+        image.add(s % 2 ? ShapeKind::TRIANGLE : ShapeKind::LINE, rand() & 0xFFFFFF, verticies,
+                  s % 4 == 1 ? SHAPE_FILLED : 0);
+    }
+
+    string streamFile = "text_save_bench_stream.tmp";
+    string writerFile = "text_save_bench_writer.tmp";
+
+    auto start = chrono::steady_clock::now();
+    ofstream streamOut(streamFile);
+    streamWrite(streamOut, image);
+    streamOut.close();
+    double streamSave = seconds(start);
+
+    start = chrono::steady_clock::now();
+    ofstream writerOut(writerFile);
+    image.out(writerOut);
+    writerOut.close();
+    double writerSave = seconds(start);
+
+    string expected = contents(streamFile);
+    bool matches = contents(writerFile) == expected;
+    remove(streamFile.c_str());
+    remove(writerFile.c_str());
+
+    cout << shapes << " shapes, " << fixed << setprecision(1) << expected.size() / 1e6 << " MB" << endl;
+    report("stream", expected.size(), streamSave, streamSave);
+    report("writer", expected.size(), writerSave, streamSave);
+
+    if(!matches){
+        cout << "saved files do not match" << endl;
+        return 1;
+    }
+    return 0;
+}
+
+/*
+ * The stream writer Image::out used to have, with the Line, Triangle and shape properties
+ * sections printed the way Line::write, Triangle::write and Shape::writeProperties did.
+ */
+static void streamWrite(ostream& os, const Image& image){
+    os << "Begin Image" << endl;
+    os << "Begin Shapes" << endl;
+    const double* packed = image.getVerticies();
+    for(unsigned int i = 0; i < image.size(); i++){
+        Shape* shape = image.getShape(i);
+        const double* verticies = packed;
+        packed += 2 * shape->getVertexCount();
+        if(shape->getKind() == ShapeKind::LINE){
+            os << "Begin Line" << endl;
+            os << "Begin Line Properties" << endl;
+            os << "\tBegin Verticies" << endl;
+            os << "\t\tv1: " << verticies[0] << "," << verticies[1] << endl;
+            os << "\t\tv2: " << verticies[2] << "," << verticies[3] << endl;
+            os << "\tEnd Verticies" << endl;
+            os << "End Line Properties" << endl;
+            streamWriteProperties(os, verticies, shape->getColor());
+            os << "End Line" << endl;
+        }else{
+            os << "Begin Triangle" << endl;
+            os << "Begin Triangle Properties" << endl;
+            os << "\tBegin Verticies" << endl;
+            os << "\t\tv1: " << verticies[0] << "," << verticies[1] << endl;
+            os << "\t\tv2: " << verticies[2] << "," << verticies[3] << endl;
+            os << "\t\tv3: " << verticies[4] << "," << verticies[5] << endl;
+            os << "\tEnd Verticies" << endl;
+            if(shape->getFlags() & SHAPE_FILLED){
+                os << "\tFill: 1" << endl;
+            }
+            os << "End Triangle Properties" << endl;
+            streamWriteProperties(os, verticies, shape->getColor());
+            os << "End Triangle" << endl;
+        }
+        delete shape;
+    }
+    os << "End Shapes" << endl;
+    os << "End Image" << endl;
+}
+
+/*
+ * The shape properties section as Shape::writeProperties used to print it.
+ */
+static void streamWriteProperties(ostream& os, const double* verticies, unsigned int color){
+    os << "Begin Shape Properties" << endl;
+    os << "\tColor: " << color << endl;
+    os << "\tLocation: " << verticies[0] << "," << verticies[1] << endl;
+    os << "End Shape Properties" << endl;
+}
+
+/*
+ * Returns the contents of a file.
+ */
+static string contents(const string& filename){
+    ifstream in(filename);
+    ostringstream text;
+    text << in.rdbuf();
+    return text.str();
+}
+
+/*
+ * Returns the seconds since start.
+ */
+static double seconds(chrono::steady_clock::time_point start){
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+/*
+ * Prints how long a writer took, its throughput and its speedup over the baseline.
+ */
+static void report(const char* what, size_t bytes, double save, double baseline){
+    cout << setw(7) << what << ": " << fixed << setprecision(1) << setw(7) << save * 1e3 << " ms ("
+         << setprecision(0) << setw(4) << bytes / 1e6 / save << " MB/s, " << setprecision(2)
+         << baseline / save << "x)" << endl;
+}
@@ -0,0 +1,170 @@
+/**
+ * transform_bench.cpp - Compares the cost of moving triangle verticies from
+ * model to device coordinates using the general matrix class, the fixed-size
+ * Mat4/PointBlock types and the batch transformPoints kernels.
+ *
+ * Build with 'make bench' and run ./bench/transform_bench [shapes]
+ */
+
+#include "matrix.h"
+#include "transform.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+using namespace std;
+
+static const int repeats = 20;
+
+static Mat4 viewTransform();
+static double benchMatrix(const vector<double>& model, vector<double>& device);
+static double benchPointBlock(const vector<double>& model, vector<double>& device);
+static double benchKernel(const vector<double>& model, vector<double>& device, SimdLevel level);
+static double benchKernelFloat(const vector<float>& model, vector<float>& device, SimdLevel level);
+static void report(const char* name, double seconds, size_t points);
+
+int main(int argc, char** argv){
+    size_t shapes = argc > 1 ? strtoul(argv[1], NULL, 10) : 100000;
+    size_t points = shapes * 3;
+
+    vector<double> model(points * 2);
+    vector<float> modelFloat(points * 2);
+    for(size_t i = 0; i < model.size(); i++){
+        model[i] = rand() % 800;
+        modelFloat[i] = model[i];
+    }
+
+    vector<double> expected(model.size());
+    vector<double> device(model.size());
+    vector<float> deviceFloat(model.size());
+
+    cout << shapes << " triangles, " << points << " points, best of " << repeats << " runs" << endl;
+
+    report("matrix operator*", benchMatrix(model, expected), points);
+    report("Mat4 * PointBlock<3>", benchPointBlock(model, device), points);
+    report("transformPoints scalar", benchKernel(model, device, SimdLevel::SCALAR), points);
+    report("transformPoints SSE2", benchKernel(model, device, SimdLevel::SSE2), points);
+    report("transformPoints AVX2", benchKernel(model, device, SimdLevel::AVX2), points);
+    report("transformPoints float SSE2", benchKernelFloat(modelFloat, deviceFloat, SimdLevel::SSE2), points);
+    report("transformPoints float AVX2", benchKernelFloat(modelFloat, deviceFloat, SimdLevel::AVX2), points);
+
+    for(size_t i = 0; i < device.size(); i++){
+        if(device[i] != expected[i]){
+            cout << "MISMATCH at " << i << ": " << device[i] << " != " << expected[i] << endl;
+            return 1;
+        }
+    }
+    cout << "detected SIMD level: " << static_cast<int>(detectSimdLevel()) << endl;
+
+    return 0;
+}
+
+/*
+ * Builds a transform like the one ViewContext produces after a few zoom, rotate and pan
+ * operations around the center of an 800x600 window.
+ */
+static Mat4 viewTransform(){
+    double theta = 10 * (3.14159265359/180.0);
+    return Mat4::translate(400,300) * Mat4::rotate(cos(theta), sin(theta)) * Mat4::scale(2,2) *
+           Mat4::translate(-400,-300) * Mat4::translate(20,-20);
+}
+
+/*
+ * The original per-shape path: a 4x4 matrix times a 4x3 matrix, with the result copied
+ * into a freshly allocated matrix as ViewContext::modelToDevice used to do.
+ */
+static double benchMatrix(const vector<double>& model, vector<double>& device){
+    Mat4 view = viewTransform();
+    matrix transform(4,4);
+    for(unsigned int i = 0; i < 4; i++){
+        for(unsigned int j = 0; j < 4; j++){
+            transform[i][j] = view(i,j);
+        }
+    }
+
+    double best = 1e30;
+    size_t shapes = model.size() / 6;
+    for(int r = 0; r < repeats; r++){
+        auto start = chrono::steady_clock::now();
+        for(size_t s = 0; s < shapes; s++){
+            matrix verticies(4,3);
+            for(unsigned int v = 0; v < 3; v++){
+                verticies[0][v] = model[6*s + 2*v];
+                verticies[1][v] = model[6*s + 2*v + 1];
+                verticies[3][v] = 1;
+            }
+            matrix* deviceCoord = new matrix(4,3);
+            *deviceCoord = transform * verticies;
+            for(unsigned int v = 0; v < 3; v++){
+                device[6*s + 2*v] = (*deviceCoord)[0][v];
+                device[6*s + 2*v + 1] = (*deviceCoord)[1][v];
+            }
+            delete deviceCoord;
+        }
+        best = min(best, chrono::duration<double>(chrono::steady_clock::now() - start).count());
+    }
+    return best;
+}
+
+/*
+ * The per-shape path using the fixed-size types.
+ */
+static double benchPointBlock(const vector<double>& model, vector<double>& device){
+    Mat4 view = viewTransform();
+
+    double best = 1e30;
+    size_t shapes = model.size() / 6;
+    for(int r = 0; r < repeats; r++){
+        auto start = chrono::steady_clock::now();
+        for(size_t s = 0; s < shapes; s++){
+            PointBlock<3> verticies;
+            for(unsigned int v = 0; v < 3; v++){
+                verticies[v] = Vec4(model[6*s + 2*v], model[6*s + 2*v + 1]);
+            }
+            PointBlock<3> deviceCoord = view * verticies;
+            for(unsigned int v = 0; v < 3; v++){
+                device[6*s + 2*v] = deviceCoord[v].x;
+                device[6*s + 2*v + 1] = deviceCoord[v].y;
+            }
+        }
+        best = min(best, chrono::duration<double>(chrono::steady_clock::now() - start).count());
+    }
+    return best;
+}
+
+/*
+ * One batch call over every point.
+ */
+static double benchKernel(const vector<double>& model, vector<double>& device, SimdLevel level){
+    Mat4 view = viewTransform();
+
+    double best = 1e30;
+    for(int r = 0; r < repeats; r++){
+        auto start = chrono::steady_clock::now();
+        transformPoints(view, model.data(), device.data(), model.size() / 2, level);
+        best = min(best, chrono::duration<double>(chrono::steady_clock::now() - start).count());
+    }
+    return best;
+}
+
+static double benchKernelFloat(const vector<float>& model, vector<float>& device, SimdLevel level){
+    Mat4 view = viewTransform();
+
+    double best = 1e30;
+    for(int r = 0; r < repeats; r++){
+        auto start = chrono::steady_clock::now();
+        transformPoints(view, model.data(), device.data(), model.size() / 2, level);
+        best = min(best, chrono::duration<double>(chrono::steady_clock::now() - start).count());
+    }
+    return best;
+}
+
+static void report(const char* name, double seconds, size_t points){
+    cout << left << setw(30) << name << right << setw(10) << fixed << setprecision(2)
+         << seconds * 1e9 / points << " ns/point" << setw(12) << setprecision(1)
+         << points / seconds / 1e6 << " Mpoints/s" << endl;
+}
@@ -1,8 +1,7 @@
 #ifndef DRAWBASE_H
 #define DRAWBASE_H
 
-// forward reference
-class GraphicsContext;
+#include "gcontext.h"	// for GraphicsContext::Rect
 
 class DrawingBase
 {
@@ -10,6 +9,11 @@ class DrawingBase
 		// prevent warnings
 		virtual ~DrawingBase(){}
 		virtual void paint(GraphicsContext* gc){}
+		// repaint only an area of the window, such as the part that
+		// was just uncovered.  Drawings that cannot do better repaint
+		// everything.
+		virtual void paint(GraphicsContext* gc,
+								const GraphicsContext::Rect& area){ paint(gc); }
 		virtual void keyDown(GraphicsContext* gc, unsigned int keycode){}
 		virtual void keyUp(GraphicsContext* gc, unsigned int keycode){}
 		virtual void mouseButtonDown(GraphicsContext* gc, 
@@ -8,8 +8,19 @@
 
 #define _USE_MATH_DEFINES	// for M_PI
 #include <cmath>	// for trig functions
+#include <cstdlib>	// for std::abs
+#include <algorithm>	// for std::min and std::max
+#include <utility>	// for std::swap
 #include "gcontext.h"	
 
+/*
+ * Constructor - drawing starts out limited only by the window
+ */
+GraphicsContext::GraphicsContext()
+	: clipping(false), clipArea()
+{
+}
+
 /*
  * Destructor - does nothing
  */
@@ -21,8 +32,9 @@ GraphicsContext::~GraphicsContext()
 
 
 /* This is a Bresenham line algorithm used to draw lines in quick and
- * efficient manner. If lines are horizontal or vertical, an alternate
- * method of drawing the line is used to increase performance
+ * efficient manner. Lines are drawn as runs of pixels, so horizontal and
+ * vertical lines become a single span. Only the part of the line inside
+ * the clip area is walked, so the cost depends on the visible length.
  * 
  * Parameters:
  * 	x0, y0 - origin of line
@@ -32,38 +44,28 @@ GraphicsContext::~GraphicsContext()
  */
 void GraphicsContext::drawLine(int x0, int y0, int x1, int y1)
 {
-	if(isHorizontal(x0,y0,x1,y1)){
-		drawHorizontalLine(x0,x1,y0);
-	}else if(isVertical(x0,y0,x1,y1)){
-		drawVerticalLine(y0,y1,x0);
+	Rect clip = getClip();
+	int right = clip.x + clip.width;
+	int bottom = clip.y + clip.height;
+
+	// nothing can be drawn, or entirely to one side of the clip area
+	if(clip.width <= 0 || clip.height <= 0 ||
+	   (x0 < clip.x && x1 < clip.x) || (y0 < clip.y && y1 < clip.y) ||
+	   (x0 >= right && x1 >= right) || (y0 >= bottom && y1 >= bottom)){
+		return;
+	}
+
+	if(std::abs((long long)y1 - y0) <= std::abs((long long)x1 - x0)){
+		if(x0 <= x1){
+			drawXMajorLine(x0,y0,x1,y1,clip);
+		}else{
+			drawXMajorLine(x1,y1,x0,y0,clip);
+		}
 	}else{
-		switch(resolveOctant(x0,y0,x1,y1)){
-			case 1:
-				drawOctantOne(x0,y0,x1,y1);
-				break;
-			case 2:
-				drawOctantTwo(x0,y0,x1,y1);
-				break;
-			case 3:
-				drawOctantThree(x0,y0,x1,y1);
-				break;
-			case 4:
-				drawOctantEight(x1,y1,x0,y0);
-				break;
-			case 5:
-				drawOctantOne(x1,y1,x0,y0);
-				break;
-			case 6:
-				drawOctantTwo(x1,y1,x0,y0);
-				break;
-			case 7:
-				drawOctantThree(x1,y1,x0,y0);
-				break;
-			case 8:
-				drawOctantEight(x0,y0,x1,y1);
-				break;
-			default:
-				break;
+		if(y0 <= y1){
+			drawYMajorLine(x0,y0,x1,y1,clip);
+		}else{
+			drawYMajorLine(x1,y1,x0,y0,clip);
 		}
 	}
 
@@ -73,7 +75,8 @@ void GraphicsContext::drawLine(int x0, int y0, int x1, int y1)
 
 
 /* This is a cicle drawing algorithm whcih uses theBresenham line 
- * to draw a circle radius pixels from the center.
+ * to draw a circle radius pixels from the center. The pixels are handed
+ * to setPixels in batches.
  * 
  * Parameters:
  * 	x0, y0 - center of circle
@@ -83,6 +86,17 @@ void GraphicsContext::drawLine(int x0, int y0, int x1, int y1)
  */
 void GraphicsContext::drawCircle(int x0, int y0, unsigned int radius)
 {
+	Rect clip = getClip();
+	long long r = radius;
+	if(clip.width <= 0 || clip.height <= 0 || x0 + r < clip.x || y0 + r < clip.y ||
+	   x0 - r >= (long long)clip.x + clip.width || y0 - r >= (long long)clip.y + clip.height){
+		return;
+	}
+
+	const unsigned int batchSize = 256;
+	Point batch[batchSize];
+	unsigned int count = 0;
+
 	int x = radius - 1;
 	int y = 0;
 	int dx = 1;
@@ -90,15 +104,19 @@ void GraphicsContext::drawCircle(int x0, int y0, unsigned int radius)
 	int err = dx - (radius << 1);
 
 	while(x >= y){
-		setPixel(x0 + x, y0 + y);
-        setPixel(x0 + y, y0 + x);
-        setPixel(x0 - y, y0 + x);
-        setPixel(x0 - x, y0 + y);
-        setPixel(x0 - x, y0 - y);
-        setPixel(x0 - y, y0 - x);
-        setPixel(x0 + y, y0 - x);
-        setPixel(x0 + x, y0 - y);
-	
+		if(count + 8 > batchSize){
+			setPixels(batch, count);
+			count = 0;
+		}
+
+		batch[count++] = {x0 + x, y0 + y};
+		batch[count++] = {x0 + y, y0 + x};
+		batch[count++] = {x0 - y, y0 + x};
+		batch[count++] = {x0 - x, y0 + y};
+		batch[count++] = {x0 - x, y0 - y};
+		batch[count++] = {x0 - y, y0 - x};
+		batch[count++] = {x0 + y, y0 - x};
+		batch[count++] = {x0 + x, y0 - y};
 
 		if(err <= 0){
 			y++;
@@ -110,223 +128,349 @@ void GraphicsContext::drawCircle(int x0, int y0, unsigned int radius)
 			err = err + dx - (radius << 1);
 		}
 	}
+
+	setPixels(batch, count);
 	
 	return;	
 }
 
-void GraphicsContext::endLoop()
-{
-	run = false;
-}
-
-/* This is a helper function which tests if a line is vertical
+/* This is a scanline implementation that fills a triangle one row at a
+ * time. Each edge limits the row to the x values on its inner side,
+ * which are found exactly with integer math, and the pixels between the
+ * limits are sent to fillSpan.
  * 
  * Parameters:
- * 	x0, y0 - origin of line
- *  x1, y1 - end of line
+ * 	x0, y0 - first vertex
+ *  x1, y1 - second vertex
+ *  x2, y2 - third vertex
  * 
- * Returns: true if vertical, false if not
+ * Returns: void
  */
-bool GraphicsContext::isVertical(int x0, int y0, int x1, int y1){
-	return x0 == x1;
+void GraphicsContext::fillTriangle(int x0, int y0, int x1, int y1, int x2, int y2)
+{
+	long long area = (long long)(x1 - x0) * (y2 - y0) - (long long)(y1 - y0) * (x2 - x0);
+	if(area == 0){
+		return;
+	}
+	if(area < 0){
+		// wind the verticies so the inside is where every edge function is positive
+		std::swap(x1, x2);
+		std::swap(y1, y2);
+	}
+
+	const int xs[3] = {x0, x1, x2};
+	const int ys[3] = {y0, y1, y2};
+
+	// only the rows and columns inside the clip area are considered
+	Rect clip = getClip();
+	int top = std::max(std::min(y0, std::min(y1, y2)), clip.y);
+	int bottom = std::min(std::max(y0, std::max(y1, y2)), clip.y + clip.height - 1);
+	int minX = std::max(std::min(x0, std::min(x1, x2)), clip.x);
+	int maxX = std::min(std::max(x0, std::max(x1, x2)), clip.x + clip.width - 1);
+
+	for(int y = top; y <= bottom; y++){
+		long long left = minX;
+		long long right = maxX;
+
+		for(int e = 0; e < 3 && left <= right; e++){
+			int ax = xs[e];
+			int ay = ys[e];
+			long long dx = xs[(e + 1) % 3] - ax;
+			long long dy = ys[(e + 1) % 3] - ay;
+
+			// (x, y) is inside this edge when dx*(y - ay) - dy*(x - ax) >= bias, where
+			// points on top and left edges count as inside and points on the others do not
+			int bias = (dy < 0 || (dy == 0 && dx > 0)) ? 0 : 1;
+			long long c = dx * (y - ay) + dy * ax - bias;
+
+			if(dy == 0){
+				if(c < 0){
+					left = right + 1;
+				}
+			}else if(dy > 0){
+				// dy*x <= c
+				right = std::min(right, floorDivide(c, dy));
+			}else{
+				// x >= c/dy, as dividing by dy flips the inequality
+				left = std::max(left, -floorDivide(c, -dy));
+			}
+		}
+
+		if(left <= right){
+			fillSpan(left, right, y);
+		}
+	}
 }
 
-/* This is a helper function which tests if a line is horizontal
+/* Sets a horizontal run of pixels one at a time.
  * 
  * Parameters:
- * 	x0, y0 - origin of line
- *  x1, y1 - end of line
+ * 	x0, x1 - x coordinate endpoints, in either order
+ *  y - y coordinate of the run
  * 
- * Returns: true if horizontal, false if not
+ * Returns: void
  */
-bool GraphicsContext::isHorizontal(int x0, int y0, int x1, int y1){
-	return y0 == y1;
+void GraphicsContext::fillSpan(int x0, int x1, int y)
+{
+	if(x0 > x1){
+		std::swap(x0, x1);
+	}
+	for(int x = x0; x <= x1; x++){
+		setPixel(x,y);
+	}
 }
 
-/* This is a helper function draws a vertical line for efficiently
- * than the algorithm used for lines that are not vertical or
- * horizontal
+/* Sets a vertical run of pixels one at a time.
  * 
  * Parameters:
- * 	x - x coordinate that line is at
- *  y0, y1 - y coordinate endpoints
+ * 	x - x coordinate of the run
+ *  y0, y1 - y coordinate endpoints, in either order
  * 
- * Returns: true if vertical, false if not
+ * Returns: void
  */
-void GraphicsContext::drawVerticalLine(int y0, int y1, int x){
-	if(y0 <= y1){
-		for(int y = y0; y <= y1; y++){
-			setPixel(x,y);
-		}
-	}else{
-		for(int y = y0; y >= y1; y--){
-			setPixel(x,y);
-		}
+void GraphicsContext::drawVSpan(int x, int y0, int y1)
+{
+	if(y0 > y1){
+		std::swap(y0, y1);
+	}
+	for(int y = y0; y <= y1; y++){
+		setPixel(x,y);
 	}
 }
 
-/* This is a helper function draws a horizontal line for efficiently
- * than the algorithm used for lines that are not vertical or
- * horizontal
+/* Sets a list of pixels one at a time.
  * 
  * Parameters:
- * 	y - y coordinate that line is at
- *  x0, x1 - x coordinate endpoints
+ * 	points - pixels to set
+ *  count - number of pixels
  * 
- * Returns: true if vertical, false if not
+ * Returns: void
  */
-void GraphicsContext::drawHorizontalLine(int x0, int x1, int y){
-	if(x0 <= x1){
-		for(int x = x0; x <= x1; x++){
-			setPixel(x,y);
-		}
-	}else{
-		for(int x = x0; x >= x1; x--){
-			setPixel(x,y);
-		}
+void GraphicsContext::setPixels(const Point* points, unsigned int count)
+{
+	for(unsigned int i = 0; i < count; i++){
+		setPixel(points[i].x, points[i].y);
 	}
 }
 
-/* This is a helper function which uses the Bresenham line algorithm 
- * to draw a line in the first octant.
- * 
- * Parameters:
- * 	x0, y0 - origin of line
- *  x1, y1 - end of line
- * 
- * Returns: void
+void GraphicsContext::endLoop()
+{
+	run = false;
+}
+
+/*
+ * Submits queued drawing - nothing is queued by default
  */
-void GraphicsContext::drawOctantOne(int x0, int y0, int x1, int y1){
-	int dy = y1-y0;
-	int dx = x1-x0;
-	int y = y0;
-	int err = 0;
+void GraphicsContext::flush()
+{
+	// nothing to do
+}
 
-	for(int x = x0; x <= x1; x++){
-		setPixel(x,y);
-		err = err + dy;
-		if((err << 1) >= dx){
-			y = y + 1;
-			err = err - dx;
-		}
-	}	
+/*
+ * Nothing to prepare for a frame by default.
+ */
+void GraphicsContext::beginFrame()
+{
 }
 
-/* This is a helper function which uses the Bresenham line algorithm 
- * to draw a line in the second octant.
+/*
+ * By default the end of a frame just makes sure it is visible.
+ */
+void GraphicsContext::endFrame()
+{
+	flush();
+}
+
+/*
+ * Limits drawing to an area of the window.  Subclasses overriding this
+ * call it so getClip stays current.
+ */
+void GraphicsContext::setClip(const Rect& area)
+{
+	clipping = true;
+	clipArea = area;
+}
+
+/*
+ * Lets drawing reach the whole window again.
+ */
+void GraphicsContext::clearClip()
+{
+	clipping = false;
+}
+
+/*
+ * Whether a clip area has been set with setClip and not cleared.
+ */
+bool GraphicsContext::hasClip()
+{
+	return clipping;
+}
+
+/*
+ * The clip area set with setClip, cut down to the window.  A clip area
+ * outside the window comes back empty, with a width or height of 0.
+ */
+GraphicsContext::Rect GraphicsContext::getClip()
+{
+	Rect window = {0, 0, getWindowWidth(), getWindowHeight()};
+	if(!clipping){
+		return window;
+	}
+
+	int left = std::max(clipArea.x, 0);
+	int top = std::max(clipArea.y, 0);
+	long long right = std::min((long long)clipArea.x + clipArea.width, (long long)window.width);
+	long long bottom = std::min((long long)clipArea.y + clipArea.height, (long long)window.height);
+
+	Rect clip = {left, top, (int)std::max(right - left, 0LL), (int)std::max(bottom - top, 0LL)};
+	return clip;
+}
+
+/* This is a helper function that divides and rounds towards negative
+ * infinity, rather than towards zero as / does.
  * 
  * Parameters:
- * 	x0, y0 - origin of line
- *  x1, y1 - end of line
+ * 	numerator - value to divide
+ *  denominator - value to divide by, must be positive
  * 
- * Returns: void
+ * Returns: floor(numerator / denominator)
  */
-void GraphicsContext::drawOctantTwo(int x0, int y0, int x1, int y1){
-	int dy = y1-y0;
-	int dx = x1-x0;
-	int x = x0;
-	int err = 0;
-
-	for(int y = y0; y <= y1; y++){
-		setPixel(x,y);
-		err = err + dx;
-		if((err << 1) >= dy){
-			x = x + 1;
-			err = err - dy;
-		}
+long long GraphicsContext::floorDivide(long long numerator, long long denominator){
+	long long quotient = numerator / denominator;
+	if(numerator % denominator < 0){
+		quotient--;
 	}
+	return quotient;
 }
 
 /* This is a helper function which uses the Bresenham line algorithm 
- * to draw a line in the eigth octant.
+ * to draw a line that is at least as wide as it is tall. y moves by
+ * one whenever the error term reaches half a pixel, and the pixels
+ * between moves are sent as one horizontal span.
+ * 
+ * Step k of the line sets (x0 + k, y0 +/- q(k)) with
+ * q(k) = floor((2k*dy + dx) / 2dx), and the error term before step k is
+ * k*dy - q(k)*dx. That lets the walk start at the first step inside the
+ * clip area, with the same pixels an unclipped walk would set. Products
+ * fit in 64 bits as long as coordinates stay within +/- 2^30.
  * 
  * Parameters:
- * 	x0, y0 - origin of line
+ * 	x0, y0 - origin of line, x0 <= x1
  *  x1, y1 - end of line
+ *  clip - area to clip to, not empty
  * 
  * Returns: void
  */
-void GraphicsContext::drawOctantEight(int x0, int y0, int x1, int y1){
-	int dy = y1-y0;
-	int dx = x1-x0;
-	int y = y0;
-	int err = 0;
+void GraphicsContext::drawXMajorLine(int x0, int y0, int x1, int y1, const Rect& clip){
+	long long dx = (long long)x1 - x0;
+	long long dy = std::abs((long long)y1 - y0);
+	int step = y0 <= y1 ? 1 : -1;
 
-	for(int x = x0; x <= x1; x++){
-		setPixel(x,y);
+	long long left = clip.x;
+	long long right = left + clip.width - 1;
+	long long top = clip.y;
+	long long bottom = top + clip.height - 1;
+
+	// steps whose x is inside the clip area
+	long long first = std::max(0LL, left - x0);
+	long long last = std::min(dx, right - x0);
+
+	// values of q(k) whose y is inside the clip area, and the steps that have them
+	long long qLow = step > 0 ? top - y0 : y0 - bottom;
+	long long qHigh = step > 0 ? bottom - y0 : y0 - top;
+	if(dy > 0){
+		qLow = std::max(qLow, 0LL);
+		qHigh = std::min(qHigh, dy);
+		first = std::max(first, -floorDivide(dx - 2 * dx * qLow, 2 * dy));
+		last = std::min(last, -floorDivide(dx - 2 * dx * (qHigh + 1), 2 * dy) - 1);
+	}else if(qLow > 0 || qHigh < 0){
+		return;
+	}
+	if(first > last){
+		return;
+	}
+
+	long long q = dx > 0 ? floorDivide(2 * first * dy + dx, 2 * dx) : 0;
+	long long err = first * dy - q * dx;
+	int y = y0 + step * q;
+	int start = x0 + first;
+	int end = x0 + last;
+
+	for(int x = start; x <= end; x++){
 		err = err + dy;
-		if((err << 1) <= dx){
-			y = y - 1;
-			err = err + dx;
+		if(2 * err >= dx){
+			fillSpan(start,x,y);
+			start = x + 1;
+			y = y + step;
+			err = err - dx;
 		}
 	}
+
+	if(start <= end){
+		fillSpan(start,end,y);
+	}
 }
 
 /* This is a helper function which uses the Bresenham line algorithm 
- * to draw a line in the third octant.
+ * to draw a line that is taller than it is wide. x moves by one
+ * whenever the error term reaches half a pixel, and the pixels between
+ * moves are sent as one vertical span. It is clipped the same way as
+ * drawXMajorLine, with the roles of x and y swapped.
  * 
  * Parameters:
- * 	x0, y0 - origin of line
+ * 	x0, y0 - origin of line, y0 <= y1
  *  x1, y1 - end of line
+ *  clip - area to clip to, not empty
  * 
  * Returns: void
  */
-void GraphicsContext::drawOctantThree(int x0, int y0, int x1, int y1){
-	int dy = y1-y0;
-	int dx = x1-x0;
-	int x = x0;
-	int err = 0;
+void GraphicsContext::drawYMajorLine(int x0, int y0, int x1, int y1, const Rect& clip){
+	long long dy = (long long)y1 - y0;
+	long long dx = std::abs((long long)x1 - x0);
+	int step = x0 <= x1 ? 1 : -1;
 
-	for(int y = y0; y <= y1; y++){
-		setPixel(x,y);
+	long long left = clip.x;
+	long long right = left + clip.width - 1;
+	long long top = clip.y;
+	long long bottom = top + clip.height - 1;
+
+	// steps whose y is inside the clip area
+	long long first = std::max(0LL, top - y0);
+	long long last = std::min(dy, bottom - y0);
+
+	// values of q(k) whose x is inside the clip area, and the steps that have them
+	long long qLow = step > 0 ? left - x0 : x0 - right;
+	long long qHigh = step > 0 ? right - x0 : x0 - left;
+	if(dx > 0){
+		qLow = std::max(qLow, 0LL);
+		qHigh = std::min(qHigh, dx);
+		first = std::max(first, -floorDivide(dy - 2 * dy * qLow, 2 * dx));
+		last = std::min(last, -floorDivide(dy - 2 * dy * (qHigh + 1), 2 * dx) - 1);
+	}else if(qLow > 0 || qHigh < 0){
+		return;
+	}
+	if(first > last){
+		return;
+	}
+
+	long long q = floorDivide(2 * first * dx + dy, 2 * dy);
+	long long err = first * dx - q * dy;
+	int x = x0 + step * q;
+	int start = y0 + first;
+	int end = y0 + last;
+
+	for(int y = start; y <= end; y++){
 		err = err + dx;
-		if((err << 1) <= dy){
-			x = x - 1;
-			err = err + dy;
+		if(2 * err >= dy){
+			drawVSpan(x,start,y);
+			start = y + 1;
+			x = x + step;
+			err = err - dy;
 		}
 	}
-}
 
-/* This is a helper function which determines the octant that a line
- * lies in space.
- * 
- * Parameters:
- * 	x0, y0 - origin of line
- *  x1, y1 - end of line
- * 
- * Returns: a value between 1 and 8 indicating octant.
- */
-unsigned int GraphicsContext::resolveOctant(int x0, int y0, int x1, int y1){
-	int dy = y1-y0;
-	int dx = x1-x0;
-
-	if(x0 < x1){
-		if(y0 < y1){
-			if(dy <= dx){
-				return 1;
-			}else {
-				return 2;
-			}
-		}else {
-			if(std::abs(dy) <= dx){
-				return 8;
-			}else{
-				return 7;
-			}
-		}
-	}else{
-		if(y0 < y1){
-			if(dy <= std::abs(dx)){
-				return 4;
-			}else{
-				return 3;
-			}
-		}else{
-			if(std::abs(dy) <= std::abs(dx)){
-				return 5;
-			}else{
-				return 6;
-			}
-		}
+	if(start <= end){
+		drawVSpan(x,start,end);
 	}
 }
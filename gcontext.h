@@ -18,11 +18,11 @@
  * context (or window).  Specific expectations for the various
  * methods are documented below.
  * 
- * Note, naive implementations of a line scan-conversion and a
- * circle scan-conversion are provided here which rely on the
- * concrete setPixel of the implemnting subclass.  These 
- * implementation are expected to be overridden for
- * better performance.
+ * Note, integer implementations of a line scan-conversion and
+ * a circle scan-conversion are provided here which rely on the
+ * concrete fillSpan and setPixels of the implementing subclass.
+ * Both clip before drawing, and may still be overridden by a
+ * context with a faster primitive of its own.
  * 
  * */    
 
@@ -44,6 +44,24 @@ class GraphicsContext
 		// existing color so that the change is reversible.		
 		enum drawMode {MODE_NORMAL, MODE_XOR};
 	
+		// A pixel location, used to hand a context many pixels at once
+		struct Point
+		{
+			int x;
+			int y;
+		};
+
+		// An area of the window in pixels, from (x, y) up to but not
+		// including (x + width, y + height).  It is empty when width or
+		// height is not positive.
+		struct Rect
+		{
+			int x;
+			int y;
+			int width;
+			int height;
+		};
+
 		// Some colors - for fun
 		static const unsigned int BLACK = 0x000000;
 		static const unsigned int BLUE = 0x0000FF;
@@ -70,6 +88,9 @@ class GraphicsContext
 		// color (which may be configurable), and start with normal
 		// (copy) drawing mode.
 	
+		// The base class only sets up the clip state.
+		GraphicsContext();
+
 		// need a virtual destructor to ensure subclasses will have
 		// their destructors called properly.  Must be virtual.
 		virtual ~GraphicsContext();
@@ -98,13 +119,62 @@ class GraphicsContext
 		// This should reset entire context to the current background
 		virtual void clear()=0;
 
-		// These are the naive implementations that use setPixel,
-		// but are overridable should a context have a better-
-		// performing version available.
+		// This should reset an area of the context to the background.
+		// The clip area does not apply.
+		virtual void clearRect(const Rect& area)=0;
+
+		// Limit every drawing operation to an area of the window until
+		// clearClip is called.  Contexts that override these must call
+		// the base versions, which keep track of the area for getClip.
+		virtual void setClip(const Rect& area);
+		virtual void clearClip();
+
+		// The area drawing is currently limited to: the window, or the
+		// part of it inside the area given to setClip.
+		Rect getClip();
+
+		// Whether a clip area has been set with setClip and not cleared.
+		bool hasClip();
+
+		// Span operations.  These let a context receive a run of pixels
+		// in one call rather than one setPixel at a time.  The defaults
+		// fall back on setPixel, but contexts are expected to override
+		// them with faster versions.
+
+		// Set every pixel from (x0, y) to (x1, y), inclusive, to the
+		// current color.  x0 and x1 may be in either order.
+		virtual void fillSpan(int x0, int x1, int y);
 
-		 /* This is a naive implementation that uses floating-point math
-		 * and "setPixel" which will need to be provided by the concrete
-		 * implementation.
+		// Set every pixel from (x, y0) to (x, y1), inclusive, to the
+		// current color.  y0 and y1 may be in either order.
+		virtual void drawVSpan(int x, int y0, int y1);
+
+		// Set count pixels to the current color.  A pixel listed twice
+		// is set twice, which matters in xor mode.
+		virtual void setPixels(const Point* points, unsigned int count);
+
+		// Contexts may queue drawing operations rather than performing
+		// them immediately.  This submits anything still queued so it
+		// becomes visible, and should be called at the end of a frame.
+		// The default does nothing, for contexts that draw immediately.
+		virtual void flush();
+
+		// Mark the start and end of a frame.  Contexts that draw
+		// off-screen show nothing drawn between the two until the end of
+		// the frame, so the frame appears all at once.  Frames may
+		// nest, only the outermost one counts.  By default beginFrame
+		// does nothing and endFrame flushes.
+		virtual void beginFrame();
+		virtual void endFrame();
+
+		// These are integer implementations built on fillSpan and
+		// setPixels, but are overridable should a context have a
+		// better-performing version available.
+
+		/* This is an integer Bresenham line clipped to the clip area
+		 * before drawing.  The first visible step and its error term
+		 * are found in closed form, so only the visible part is walked,
+		 * and each run of pixels on one row goes to fillSpan.
 		 * 
 		 * Parameters:
 		 * 	x0, y0 - origin of line
@@ -114,9 +184,10 @@ class GraphicsContext
 		 */
 		virtual void drawLine(int x0, int y0, int x1, int y1);
 		
-		/* This is a naive implementation that uses floating-point math
-		 * and "setPixel" which will need to be provided by the concrete
-		 * implementation.
+		/* This is an integer midpoint circle.  A circle entirely outside
+		 * the clip area is skipped before drawing, and the points of the
+		 * eight octants are handed to setPixels in batches, which clips
+		 * them one by one.
 		 * 
 		 * Parameters:
 		 * 	x0, y0 - origin/center of circle
@@ -126,6 +197,21 @@ class GraphicsContext
 		 */
 		virtual void drawCircle(int x0, int y0, unsigned int radius);
 
+		/* This is a scanline implementation that fills a triangle one
+		 * row at a time with fillSpan.  A pixel is filled when its
+		 * corner (x, y) lies inside the triangle.  Pixels exactly on an
+		 * edge are only filled for top and left edges, so triangles
+		 * that share an edge never both fill the pixels along it.
+		 * 
+		 * Parameters:
+		 * 	x0, y0 - first vertex
+		 *  x1, y1 - second vertex
+		 *  x2, y2 - third vertex
+		 * 
+		 * Returns: void
+		 */
+		virtual void fillTriangle(int x0, int y0, int x1, int y1, int x2, int y2);
+
 
 		/*********************************************************
 		 * Event loop operations
@@ -158,105 +244,46 @@ class GraphicsContext
 		bool run;
 
 	private:
-		/* This is a helper function which determines the octant that a line
-		* lies in space.
-		* 
-		* Parameters:
-		* 	x0, y0 - origin of line
-		*  x1, y1 - end of line
-		* 
-		* Returns: a value between 1 and 8 indicating octant.
-		*/
-		unsigned int resolveOctant(int x0, int y0, int x1, int y1);
-
-		/* This is a helper function which tests if a line is vertical
-		* 
-		* Parameters:
-		* 	x0, y0 - origin of line
-		*  x1, y1 - end of line
-		* 
-		* Returns: true if vertical, false if not
-		*/
-		bool isVertical(int x0, int y0, int x1, int y1);
-
-		/* This is a helper function which tests if a line is horizontal
-		* 
-		* Parameters:
-		* 	x0, y0 - origin of line
-		*  x1, y1 - end of line
-		* 
-		* Returns: true if horizontal, false if not
-		*/
-		bool isHorizontal(int x0, int y0, int x1, int y1);
-
-		/* This is a helper function draws a horizontal line for efficiently
-		* than the algorithm used for lines that are not vertical or
-		* horizontal
-		* 
-		* Parameters:
-		* 	y - y coordinate that line is at
-		*  x0, x1 - x coordinate endpoints
-		* 
-		* Returns: true if vertical, false if not
-		*/
-		void drawHorizontalLine(int x0, int x1, int y);
-
-		/* This is a helper function draws a vertical line for efficiently
-		* than the algorithm used for lines that are not vertical or
-		* horizontal
-		* 
-		* Parameters:
-		* 	x - x coordinate that line is at
-		*  y0, y1 - y coordinate endpoints
-		* 
-		* Returns: true if vertical, false if not
-		*/
-		void drawVerticalLine(int y0, int y1, int y);
-
-
-		/* This is a helper function which uses the Bresenham line algorithm 
-		* to draw a line in the first octant.
-		* 
-		* Parameters:
-		* 	x0, y0 - origin of line
-		*  x1, y1 - end of line
-		* 
-		* Returns: void
-		*/
-		void drawOctantOne(int x0, int y0, int x1, int y1);
+		// the area given to setClip, if clipping is set
+		bool clipping;
+		Rect clipArea;
 
 		/* This is a helper function which uses the Bresenham line algorithm 
-		* to draw a line in the second octant.
+		* to draw the part of a line inside the clip area that is at least as
+		* wide as it is tall, as a series of horizontal spans.
 		* 
 		* Parameters:
-		* 	x0, y0 - origin of line
+		* 	x0, y0 - origin of line, x0 <= x1
 		*  x1, y1 - end of line
+		*  clip - area to clip to, not empty
 		* 
 		* Returns: void
 		*/
-		void drawOctantTwo(int x0, int y0, int x1, int y1);
+		void drawXMajorLine(int x0, int y0, int x1, int y1, const Rect& clip);
 
 		/* This is a helper function which uses the Bresenham line algorithm 
-		* to draw a line in the third octant.
+		* to draw the part of a line inside the clip area that is taller than
+		* it is wide, as a series of vertical spans.
 		* 
 		* Parameters:
-		* 	x0, y0 - origin of line
+		* 	x0, y0 - origin of line, y0 <= y1
 		*  x1, y1 - end of line
+		*  clip - area to clip to, not empty
 		* 
 		* Returns: void
 		*/
-		void drawOctantThree(int x0, int y0, int x1, int y1);
+		void drawYMajorLine(int x0, int y0, int x1, int y1, const Rect& clip);
 
-		/* This is a helper function which uses the Bresenham line algorithm 
-		* to draw a line in the eigth octant.
+		/* This is a helper function that divides and rounds towards
+		* negative infinity, rather than towards zero as / does.
 		* 
 		* Parameters:
-		* 	x0, y0 - origin of line
-		*  x1, y1 - end of line
+		* 	numerator - value to divide
+		*  denominator - value to divide by, must be positive
 		* 
-		* Returns: void
+		* Returns: floor(numerator / denominator)
 		*/
-		void drawOctantEight(int x0, int y0, int x1, int y1);
+		static long long floorDivide(long long numerator, long long denominator);
 
 };
 
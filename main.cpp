@@ -8,6 +8,7 @@
 #include "Line.h"
 #include "Triangle.h"
 #include "Image.h"
+#include <cstring>
 #include <iostream>
 #include <unistd.h>
 #include <fstream>
@@ -19,7 +20,7 @@
 static GraphicsContext* gc;
 static ViewContext* vc;
 
-static void initialize();
+static void initialize(X11Context::backbufferType backbuffer);
 static void testLine();
 static void testTriangle();
 static void testImage();
@@ -31,18 +32,31 @@ static void lab5();
 using namespace std;
 
 /* 
- * This is a driver for testing the Shapes functionality
+ * This is a driver for testing the Shapes functionality. Passing --image draws into a
+ * client-side image, shared with the X server through MIT-SHM where it can be, rather than
+ * into a server-side Pixmap.
  * 
  * Parameters:
- * 	none
+ * 	argc - number of command line arguments
+ *  argv - the command line arguments
  * 
  * Returns:
  *  0 if successful
  */
-int main(){
+int main(int argc, char** argv){
     int mode = 6;
 
-    initialize();
+    X11Context::backbufferType backbuffer = X11Context::BACKBUFFER_PIXMAP;
+    for(int i = 1; i < argc; i++){
+        if(std::strcmp(argv[i], "--image") == 0){
+            backbuffer = X11Context::BACKBUFFER_IMAGE;
+        }else{
+            cerr << "Usage: " << argv[0] << " [--image]" << endl;
+            return 1;
+        }
+    }
+
+    initialize(backbuffer);
     if(mode==0) testLine();
     if(mode==1) testTriangle();
     if(mode==2) testImage();
@@ -56,8 +70,8 @@ int main(){
     return 0;
 }
 
-static void initialize(){
-    gc = new X11Context(800,600,GraphicsContext::BLACK);
+static void initialize(X11Context::backbufferType backbuffer){
+    gc = new X11Context(800,600,GraphicsContext::BLACK,backbuffer);
     vc = new ViewContext(gc->getWindowWidth()/2, gc->getWindowHeight()/2,0);
 }
 
@@ -267,6 +281,7 @@ static void testLine(){
     line6 = line2;
     line6.out(cout);
 
+    gc->flush();
     sleep(5);
 
     delete line4;
@@ -321,5 +336,6 @@ static void testTriangle(){
 
     cout << ">>Triangle tests finished" << endl;
 
+    gc->flush();
     sleep(5);
 }
\ No newline at end of file
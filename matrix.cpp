@@ -28,6 +28,27 @@ matrix::matrix(unsigned int rows, unsigned int cols) : rows(rows), cols(cols)
 	createEmptyMatrix(rows, cols);
 }
 
+/**
+ * Parameterized contstuctor using caller provided storage, which the
+ * matrix will not free.
+ * Input:
+ *      rows - 0 based number of rows in matrix
+ *      cols - 0 based number of columns in matrix
+ *      storage - at least storageSize(rows, cols) bytes, aligned for a double
+ * Output:
+ *      new matrix object
+ * Thows:
+ * 		matrixException - thown if rows or cols < 0
+ **/
+matrix::matrix(unsigned int rows, unsigned int cols, void* storage) : rows(rows), cols(cols)
+{
+	if (rows < 1 || cols < 1)
+	{
+		throw matrixException("p-constructor bad arguments");
+	}
+	createEmptyMatrix(rows, cols, storage);
+}
+
 /**
  * Copy contstuctor. Takes an object and returns a new object
  * exactly like the object passed in.
@@ -36,22 +57,37 @@ matrix::matrix(unsigned int rows, unsigned int cols) : rows(rows), cols(cols)
  * Output:
  *      new matrix object
  **/
-matrix::matrix(const matrix &from) : rows(from.rows), cols(from.cols)
+matrix::matrix(const matrix &from) : the_matrix(nullptr), rows(0), cols(0), ownsStorage(true)
 {
-	the_matrix = new double*[rows];
+	if (from.rows > 0)
+	{
+		createEmptyMatrix(from.rows, from.cols);
+	}
 
 	for (unsigned int i = 0; i < rows; i++)
 	{
-		the_matrix[i] = new double[cols];
-
 		for (unsigned int j = 0; j < cols; j++)
 		{
 			the_matrix[i][j] = from[i][j];
 		}
 	}
+}
 
-	this->rows = rows;
-	this->cols = cols;
+/**
+ * Move contstuctor. Takes ownership of the storage of from, leaving
+ * from as an empty matrix.
+ * Input:
+ *      from - rvalue reference to matrix to move from
+ * Output:
+ *      new matrix object
+ **/
+matrix::matrix(matrix &&from) noexcept : the_matrix(from.the_matrix), rows(from.rows), cols(from.cols),
+	ownsStorage(from.ownsStorage)
+{
+	from.the_matrix = nullptr;
+	from.rows = 0;
+	from.cols = 0;
+	from.ownsStorage = true;
 }
 
 /**
@@ -81,20 +117,18 @@ matrix &matrix::operator=(const matrix &rhs)
 	if (this->rows != rhs.rows || this->cols != rhs.cols)
 	{
 		erase();
-		the_matrix = new double*[rhs.rows];
-
-		for (unsigned int i = 0; i < rhs.rows; i++)
+		if (rhs.rows > 0)
 		{
-			the_matrix[i] =  new double[rhs.cols];
+			createEmptyMatrix(rhs.rows, rhs.cols);
+		}
 
-			for (unsigned int j = 0; j < rhs.cols; j++)
+		for (unsigned int i = 0; i < rows; i++)
+		{
+			for (unsigned int j = 0; j < cols; j++)
 			{
 				the_matrix[i][j] = rhs[i][j];
 			}
 		}
-
-		this->rows = rhs.rows;
-		this->cols = rhs.cols;
 	} else {
 		for (unsigned int i = 0; i < rows; i++)
 		{
@@ -108,6 +142,48 @@ matrix &matrix::operator=(const matrix &rhs)
 	return *this;
 }
 
+/**
+ * Move assignment. Frees the storage held by this matrix and takes
+ * ownership of the storage of rhs, leaving rhs as an empty matrix.
+ * Input:
+ *      rhs - rvalue reference to matrix to move from
+ * Output:
+ *      *this - refers to reassigned matrix object
+ **/
+matrix &matrix::operator=(matrix &&rhs) noexcept
+{
+	if (this != &rhs)
+	{
+		erase();
+
+		the_matrix = rhs.the_matrix;
+		rows = rhs.rows;
+		cols = rhs.cols;
+		ownsStorage = rhs.ownsStorage;
+
+		rhs.the_matrix = nullptr;
+		rhs.rows = 0;
+		rhs.cols = 0;
+		rhs.ownsStorage = true;
+	}
+
+	return *this;
+}
+
+/**
+ * Number of bytes of storage a matrix of the given size occupies: a
+ * table of row pointers followed by the cells.
+ * Input:
+ *      rows - number of rows in the matrix
+ *      cols - number of columns in the matrix
+ * Output:
+ *      size_t - bytes of storage
+ **/
+std::size_t matrix::storageSize(unsigned int rows, unsigned int cols)
+{
+	return rows * sizeof(double*) + rows * cols * sizeof(double);
+}
+
 /**
  * Creates the Identity matrix. This is essentially a
  * named constructor.
@@ -146,14 +222,7 @@ matrix matrix::operator+(const matrix &rhs) const
 	}
 
 	matrix tempMatrix = *this;
-
-	for (unsigned int i = 0; i < this->rows; i++)
-	{
-		for (unsigned int j = 0; j < this->cols; j++)
-		{
-			tempMatrix[i][j] = the_matrix[i][j] + rhs[i][j];
-		}
-	}
+	tempMatrix += rhs;
 
 	return tempMatrix;
 }
@@ -178,19 +247,7 @@ matrix matrix::operator*(const matrix &rhs) const
 	}
 
 	matrix tempMatrix = matrix(this->rows, rhs.cols);
-
-	for (unsigned int i = 0; i < this->rows; i++)
-	{
-		for (unsigned int j = 0; j < rhs.cols; j++)
-		{
-			double result = 0;
-			for (unsigned int k = 0; k < this->cols; k++)
-			{
-				result += (the_matrix[i])[k] * rhs[k][j];
-			}
-			tempMatrix[i][j] = result;
-		}
-	}
+	multiplyInto(*this, rhs, tempMatrix);
 
 	return tempMatrix;
 }
@@ -206,16 +263,144 @@ matrix matrix::operator*(const matrix &rhs) const
 matrix matrix::operator*(const double scale) const
 {
 	matrix tempMatrix = *this;
+	tempMatrix *= scale;
+
+	return tempMatrix;
+}
+
+/**
+ * Adds rhs to this matrix in place.
+ * Input:
+ *      rhs - reference to the matrix to be added to "this"
+ * Output:
+ *      *this - refers to the updated matrix
+ * Thows:
+ * 		matrixException - thown if the matrices are not the same size
+ **/
+matrix &matrix::operator+=(const matrix &rhs)
+{
+	if (rhs.rows != this->rows || rhs.cols != this->cols)
+	{
+		throw matrixException("Matrixies must have the same number of rows and columns");
+	}
 
 	for (unsigned int i = 0; i < rows; i++)
 	{
 		for (unsigned int j = 0; j < cols; j++)
 		{
-			tempMatrix[i][j] = scale * (the_matrix[i])[j];
+			the_matrix[i][j] += rhs.the_matrix[i][j];
 		}
 	}
 
-	return tempMatrix;
+	return *this;
+}
+
+/**
+ * Multiplies this matrix by rhs in place (this = this * rhs).
+ * Input:
+ *      rhs - reference to the matrix to multiply "this" by
+ * Output:
+ *      *this - refers to the updated matrix
+ * Thows:
+ * 		matrixException - thown if this->cols != rhs.rows
+ **/
+matrix &matrix::operator*=(const matrix &rhs)
+{
+	multiplyInto(*this, rhs, *this);
+	return *this;
+}
+
+/**
+ * Multiplies every element of this matrix by a scalar in place.
+ * Input:
+ *      scale - value to multiple matrix elements by
+ * Output:
+ *      *this - refers to the updated matrix
+ **/
+matrix &matrix::operator*=(const double scale)
+{
+	for (unsigned int i = 0; i < rows; i++)
+	{
+		for (unsigned int j = 0; j < cols; j++)
+		{
+			the_matrix[i][j] *= scale;
+		}
+	}
+
+	return *this;
+}
+
+/**
+ * Performs cross multiplication of two matrix objects, storing the
+ * result in out.  out keeps its storage when it is already the right
+ * size, and may alias lhs or rhs.
+ * Input:
+ *      lhs - left operand
+ *      rhs - right operand
+ *      out - destination of the product
+ * Output:
+ *      none
+ * Thows:
+ * 		matrixException - thown if lhs.cols != rhs.rows
+ **/
+void matrix::multiplyInto(const matrix &lhs, const matrix &rhs, matrix &out)
+{
+	if (lhs.cols != rhs.rows)
+	{
+		throw matrixException("Illegal martix sizes for matrix multiplication.");
+	}
+
+	// Every element of the result reads a full column of rhs, so writing
+	// into rhs (or into lhs when it changes shape) would corrupt inputs that
+	// are still needed.  Fall back to a temporary for those cases.
+	if (&out == &rhs || (&out == &lhs && rhs.rows != rhs.cols))
+	{
+		out = lhs * rhs;
+		return;
+	}
+
+	// When out is lhs each row of the result only depends on the same row of
+	// lhs, so one row of scratch space is enough to multiply in place.
+	const unsigned int stackCols = 8;
+	double stackRow[stackCols];
+	double *scratch = nullptr;
+	if (&out == &lhs)
+	{
+		scratch = rhs.cols <= stackCols ? stackRow : new double[rhs.cols];
+	}
+	else
+	{
+		out.resize(lhs.rows, rhs.cols);
+	}
+
+	for (unsigned int i = 0; i < lhs.rows; i++)
+	{
+		const double *lhsRow = lhs.the_matrix[i];
+		double *outRow = scratch ? scratch : out.the_matrix[i];
+
+		for (unsigned int j = 0; j < rhs.cols; j++)
+		{
+			double result = 0;
+			for (unsigned int k = 0; k < lhs.cols; k++)
+			{
+				result += lhsRow[k] * rhs.the_matrix[k][j];
+			}
+			outRow[j] = result;
+		}
+
+		if (scratch)
+		{
+			for (unsigned int j = 0; j < rhs.cols; j++)
+			{
+				out.the_matrix[i][j] = scratch[j];
+			}
+		}
+	}
+
+	if (scratch && scratch != stackRow)
+	{
+		delete[] scratch;
+	}
 }
 
 /**
@@ -261,6 +446,30 @@ void matrix::clear()
 	return;
 }
 
+/**
+ * Returns the number of rows in the matrix.
+ * Input:
+ *      none
+ * Output:
+ *      number of rows
+ **/
+unsigned int matrix::getRows() const
+{
+	return rows;
+}
+
+/**
+ * Returns the number of columns in the matrix.
+ * Input:
+ *      none
+ * Output:
+ *      number of columns
+ **/
+unsigned int matrix::getCols() const
+{
+	return cols;
+}
+
 /**
  * Access operator that allows a row to be accessed from the matrix. 
  * Includes index access protection.
@@ -273,7 +482,7 @@ void matrix::clear()
  **/
 matrix::matrix_row matrix::operator[](unsigned int row)
 {
-	if (row > rows - 1)
+	if (row >= rows)
 	{
 		throw matrixException("Attempting to access a matrix row that does not exist.");
 	}
@@ -293,7 +502,7 @@ matrix::matrix_row matrix::operator[](unsigned int row)
  **/
 matrix::matrix_row matrix::operator[](unsigned int row) const
 {
-	if (row > rows - 1)
+	if (row >= rows)
 	{
 		throw matrixException("Attempting to access a matrix row that does not exist.");
 	}
@@ -335,38 +544,67 @@ std::ostream &matrix::out(std::ostream &os) const
  **/
 void matrix::erase()
 {
-	for (unsigned int i = 0; i < rows; i++)
+	if (ownsStorage)
 	{
-		delete[] the_matrix[i];
+		::operator delete(the_matrix);
 	}
 
-	delete[] the_matrix;
+	the_matrix = nullptr;
+	ownsStorage = true;
 	rows = 0;
 	cols = 0;
 }
 
 /**
- * Private helper method to initialize a blank matrix
+ * Private helper method to make the matrix a given size, only reallocating
+ * the underlying storage when the size actually changes.
+ * Input:
+ *      rows - number of rows in the matrix
+ * 		cols - number of columns in the matrix
+ * Output:
+ *      none
+ **/
+void matrix::resize(unsigned int rows, unsigned int cols)
+{
+	if (this->rows != rows || this->cols != cols)
+	{
+		erase();
+		createEmptyMatrix(rows, cols);
+	}
+}
+
+/**
+ * Private helper method to initialize a blank matrix.  The row table is
+ * followed by the cells in a single block, so a matrix costs one
+ * allocation, or none when storage is given.
  * Input:
  *      row - 0 based rows in the matrix
  * 		cols - 0 based columns in the matrix
+ * 		storage - storageSize(rows, cols) bytes to use, or nullptr to allocate
  * Output:
  *      none
  * Throws:
  * 		matrixException - if rows or columns are less than 1
  **/
-void matrix::createEmptyMatrix(int rows, int cols)
+void matrix::createEmptyMatrix(int rows, int cols, void* storage)
 {
 	if (rows < 1 || cols < 1)
 	{
 		throw matrixException("p-constructor bad arguments");
 	}
 
-	the_matrix = new double*[rows];
+	ownsStorage = storage == nullptr;
+	if (ownsStorage)
+	{
+		storage = ::operator new(storageSize(rows, cols));
+	}
+
+	the_matrix = static_cast<double**>(storage);
+	double* cells = reinterpret_cast<double*>(the_matrix + rows);
 
 	for (int i = 0; i < rows; i++)
 	{
-		the_matrix[i] = new double[cols];
+		the_matrix[i] = cells + i * cols;
 
 		for (int j = 0; j < cols; j++)
 		{
@@ -406,7 +644,7 @@ matrix::matrix_row::matrix_row(double* row, unsigned int cols){
  **/
 double& matrix::matrix_row::operator[](unsigned int col)
 {
-	if (col > cols - 1)
+	if (col >= cols)
 	{
 		throw matrixException("Error attempting to access column outside of matrix row.");
 	}
@@ -425,7 +663,7 @@ double& matrix::matrix_row::operator[](unsigned int col)
  **/
 double& matrix::matrix_row::operator[](unsigned int col) const
 {
-	if (col > cols - 1)
+	if (col >= cols)
 	{
 		throw matrixException("Error attempting to access column outside of matrix row.");
 	}
@@ -15,6 +15,7 @@
 #ifndef MATRIX_H
 #define MATRIX_H
  
+#include <cstddef>	// for std::size_t
 #include <iostream> // for std::ostream
 #include <stdexcept>	// for std::runtime_error
 #include <string>	// used in exception
@@ -90,9 +91,23 @@ class matrix
 		// throw (matrixException)
 		//
 		matrix(unsigned int rows, unsigned int cols);
+
+		// Constructor - as above, but the cells are placed in caller provided
+		// storage of at least storageSize(rows, cols) bytes, aligned for a
+		// double.  The matrix never frees this storage, so it must outlive
+		// the matrix.  Assigning a matrix of a different size moves the
+		// matrix back to storage of its own.
+		matrix(unsigned int rows, unsigned int cols, void* storage);
+
+		// Number of bytes of storage a rows x cols matrix occupies
+		static std::size_t storageSize(unsigned int rows, unsigned int cols);
  
 		// Copy constructor - make a new Matrix just like rhs
 		matrix(const matrix& from);
+
+		// Move constructor - take ownership of the storage of from.  from is
+		// left empty (0x0) and may only be assigned to or destroyed.
+		matrix(matrix&& from) noexcept;
  
 		// Destructor.  Free allocated memory
 		~matrix();
@@ -100,6 +115,9 @@ class matrix
 		// Assignment operator - make this just like rhs.  Must function
         // correctly even if rhs is a different size than this.
 		matrix& operator=(const matrix& rhs);
+
+		// Move assignment - release this matrix's storage and take rhs's.
+		matrix& operator=(matrix&& rhs) noexcept;
  
 		// "Named" constructor(s).  This is not a language mechanism, rather
 		// a common programming idiom.  The underlying issue is that with
@@ -139,11 +157,33 @@ class matrix
 		// someMatrixObject * 5.0, but not 5.0 * someMatrixObject.
 		matrix operator*(const double scale) const;
 
+		// In-place versions of the above.  These reuse the storage of this
+		// matrix rather than producing a new one.
+		//
+		// throw (matrixException)
+		//
+		matrix& operator+=(const matrix& rhs);
+		matrix& operator*=(const matrix& rhs);
+		matrix& operator*=(const double scale);
+
+		// Matrix multiplication into an existing matrix - out = lhs * rhs.
+		// out is only reallocated when its size does not match the result,
+		// so repeated products into the same destination do not allocate.
+		// out may be the same object as lhs or rhs.
+		//
+		// throw (matrixException)
+		//
+		static void multiplyInto(const matrix& lhs, const matrix& rhs, matrix& out);
+
 		// Transpose of a Matrix - should always work, hence no exception
 		matrix operator~() const;
  
 		// Clear Matrix to all members 0.0
 		void clear();
+
+		// Dimensions of the matrix
+		unsigned int getRows() const;
+		unsigned int getCols() const;
   
 		// Access Operators - throw an exception if index out of range
 		//
@@ -189,6 +229,9 @@ class matrix
 		unsigned int rows;
 		unsigned int cols;
 
+		// false when the_matrix lives in storage handed to the constructor
+		bool ownsStorage;
+
 		/** routines **/
 
 		//Private helper function to erase the underlying 2D array. This is made
@@ -197,8 +240,14 @@ class matrix
 		void erase();
 
 		//private helper function so that the underlying 2D array can be called
-		//from matrix methods. This is necessary in the = operator override
-		void createEmptyMatrix(int rows, int cols);
+		//from matrix methods. This is necessary in the = operator override.
+		//The row table and cells are laid out in one block, which is
+		//allocated unless storage is given.
+		void createEmptyMatrix(int rows, int cols, void* storage = nullptr);
+
+		//private helper function that makes this matrix rows x cols, only
+		//reallocating if the size changes.  Contents are unspecified afterwards.
+		void resize(unsigned int rows, unsigned int cols);
 		// add any "helper" routine here, such as routines to support
 		// matrix inversion
 
@@ -232,5 +281,157 @@ std::ostream& operator<<(std::ostream& os, const matrix& rhs);
 // support 5.0 * someMatrixObject, but not someMatrixObject * 5.0
 matrix operator*(const double scale, const matrix& rhs);
 
+
+/** Fixed-size Homogeneous Types **/
+
+// The matrix class above is general purpose, but every instance lives on the
+// heap with one allocation per row.  Nearly all of the math done while
+// drawing is a 4x4 homogeneous transform applied to a handful of 4x1 points,
+// so these fixed-size value types exist for that path.  They are contiguous,
+// live on the stack, never allocate and never throw.
+
+// A single homogeneous point/vector.  Points default to w = 1.
+struct Vec4
+{
+	double x;
+	double y;
+	double z;
+	double w;
+
+	constexpr Vec4() : x(0.0), y(0.0), z(0.0), w(1.0) {}
+	constexpr Vec4(double x, double y, double z = 0.0, double w = 1.0) :
+		x(x), y(y), z(z), w(w) {}
+};
+
+// A block of N homogeneous points.  This is the fixed-size counterpart of a
+// 4xN matrix where each column is a vertex of a shape.
+template <unsigned int N>
+struct PointBlock
+{
+	Vec4 points[N];
+
+	constexpr PointBlock() : points() {}
+
+	/**
+	 * Copies the first N columns of a 4xN (or wider) matrix into the block.
+	 * Input:
+	 *      from - matrix holding one vertex per column
+	 * Output:
+	 *      new point block
+	 * Thows:
+	 * 		matrixException - thown if from has fewer than 4 rows or N columns
+	 **/
+	explicit PointBlock(const matrix& from)
+	{
+		for (unsigned int i = 0; i < N; i++)
+		{
+			points[i] = Vec4(from[0][i], from[1][i], from[2][i], from[3][i]);
+		}
+	}
+
+	constexpr Vec4& operator[](unsigned int i) { return points[i]; }
+	constexpr const Vec4& operator[](unsigned int i) const { return points[i]; }
+};
+
+class Mat4
+{
+	public:
+		// Zero matrix
+		constexpr Mat4() : m() {}
+
+		// Named Constructor - 4x4 identity matrix
+		static constexpr Mat4 identity()
+		{
+			Mat4 result;
+			for (unsigned int i = 0; i < 4; i++)
+			{
+				result.m[i][i] = 1.0;
+			}
+			return result;
+		}
+
+		// Named Constructor - translation by (x, y, z)
+		static constexpr Mat4 translate(double x, double y, double z = 0.0)
+		{
+			Mat4 result = identity();
+			result.m[0][3] = x;
+			result.m[1][3] = y;
+			result.m[2][3] = z;
+			return result;
+		}
+
+		// Named Constructor - scale by a, b and c along x, y and z
+		static constexpr Mat4 scale(double a, double b, double c = 1.0)
+		{
+			Mat4 result = identity();
+			result.m[0][0] = a;
+			result.m[1][1] = b;
+			result.m[2][2] = c;
+			return result;
+		}
+
+		// Named Constructor - rotation about the z axis.  The cosine and sine
+		// of the angle are passed in so that the builder stays constexpr.
+		static constexpr Mat4 rotate(double cosTheta, double sinTheta)
+		{
+			Mat4 result = identity();
+			result.m[0][0] = cosTheta;
+			result.m[0][1] = -sinTheta;
+			result.m[1][0] = sinTheta;
+			result.m[1][1] = cosTheta;
+			return result;
+		}
+
+		// Element access - no bounds checking is performed
+		constexpr double& operator()(unsigned int row, unsigned int col)
+		{
+			return m[row][col];
+		}
+
+		constexpr double operator()(unsigned int row, unsigned int col) const
+		{
+			return m[row][col];
+		}
+
+		// Matrix multiplication
+		constexpr Mat4 operator*(const Mat4& rhs) const
+		{
+			Mat4 result;
+			for (unsigned int i = 0; i < 4; i++)
+			{
+				for (unsigned int j = 0; j < 4; j++)
+				{
+					result.m[i][j] = m[i][0] * rhs.m[0][j] + m[i][1] * rhs.m[1][j] +
+					                 m[i][2] * rhs.m[2][j] + m[i][3] * rhs.m[3][j];
+				}
+			}
+			return result;
+		}
+
+		// Transform a single point
+		constexpr Vec4 operator*(const Vec4& v) const
+		{
+			return Vec4(m[0][0] * v.x + m[0][1] * v.y + m[0][2] * v.z + m[0][3] * v.w,
+			            m[1][0] * v.x + m[1][1] * v.y + m[1][2] * v.z + m[1][3] * v.w,
+			            m[2][0] * v.x + m[2][1] * v.y + m[2][2] * v.z + m[2][3] * v.w,
+			            m[3][0] * v.x + m[3][1] * v.y + m[3][2] * v.z + m[3][3] * v.w);
+		}
+
+		// Transform every point in a block
+		template <unsigned int N>
+		constexpr PointBlock<N> operator*(const PointBlock<N>& rhs) const
+		{
+			PointBlock<N> result;
+			for (unsigned int i = 0; i < N; i++)
+			{
+				result.points[i] = *this * rhs.points[i];
+			}
+			return result;
+		}
+
+	private:
+		double m[4][4];
+};
+
  
 #endif
\ No newline at end of file
@@ -0,0 +1,239 @@
+/* Provides a drawing context that renders into memory.  Pixels outside
+ * the framebuffer or the clip area are ignored, just as X11 clips them.
+ */
+
+#include <algorithm>
+#include <utility>
+#include "memorycontext.h"
+#include "drawbase.h"
+
+static const unsigned int OPAQUE = 0xFF000000;
+static const unsigned int RGB_MASK = 0x00FFFFFF;
+
+/**
+ * Creates the framebuffer and clears it to the background color.  As with
+ * X11Context the drawing color starts out white in normal (copy) mode.
+ * */
+MemoryContext::MemoryContext(unsigned int sizex, unsigned int sizey, unsigned int bg_color)
+	: width(sizex), height(sizey), storage(sizex * sizey), pixels(storage.data()),
+	  color(OPAQUE | GraphicsContext::WHITE), background(OPAQUE | (bg_color & RGB_MASK)),
+	  mode(MODE_NORMAL)
+{
+	run = false;
+	clearClip();
+	clear();
+}
+
+/**
+ * The same, but drawing into pixels that belong to the caller.
+ * */
+MemoryContext::MemoryContext(unsigned int sizex, unsigned int sizey,
+								unsigned int* framebuffer, unsigned int bg_color)
+	: width(sizex), height(sizey), pixels(framebuffer),
+	  color(OPAQUE | GraphicsContext::WHITE), background(OPAQUE | (bg_color & RGB_MASK)),
+	  mode(MODE_NORMAL)
+{
+	run = false;
+	clearClip();
+	clear();
+}
+
+// Destructor - nothing to release beyond the members
+MemoryContext::~MemoryContext()
+{
+}
+
+// Set the drawing mode - argument is enumerated
+void MemoryContext::setMode(drawMode newMode)
+{
+	mode = newMode;
+}
+
+// Set drawing color - color is 24 bit RGB
+void MemoryContext::setColor(unsigned int color)
+{
+	this->color = OPAQUE | (color & RGB_MASK);
+}
+
+// Set a pixel in the current color, or xor it with the current color
+void MemoryContext::setPixel(int x, int y)
+{
+	if (x < clipLeft || y < clipTop || x >= clipRight || y >= clipBottom)
+		return;
+
+	unsigned int& pixel = pixels[y * width + x];
+	if (mode == MODE_XOR)
+		pixel ^= color & RGB_MASK;
+	else
+		pixel = color;
+}
+
+// Get the 24-bit RGB color of a pixel, black outside the framebuffer
+unsigned int MemoryContext::getPixel(int x, int y)
+{
+	if (x < 0 || y < 0 || x >= width || y >= height)
+		return GraphicsContext::BLACK;
+
+	return pixels[y * width + x] & RGB_MASK;
+}
+
+void MemoryContext::clear()
+{
+	std::fill(pixels, pixels + width * height, background);
+}
+
+// Reset an area to the background, clipped to the framebuffer only
+void MemoryContext::clearRect(const Rect& area)
+{
+	int left = std::max(area.x, 0);
+	int top = std::max(area.y, 0);
+	int right = std::min((long long)area.x + area.width, (long long)width);
+	int bottom = std::min((long long)area.y + area.height, (long long)height);
+	if (left >= right)
+		return;
+
+	for (int y = top; y < bottom; y++)
+		std::fill(&pixels[y * width + left], &pixels[y * width + right], background);
+}
+
+// Limit drawing to an area, keeping the bounds at hand for the pixel
+// operations
+void MemoryContext::setClip(const Rect& area)
+{
+	GraphicsContext::setClip(area);
+	updateClip();
+}
+
+void MemoryContext::clearClip()
+{
+	GraphicsContext::clearClip();
+	updateClip();
+}
+
+void MemoryContext::updateClip()
+{
+	Rect clip = getClip();
+	clipLeft = clip.x;
+	clipTop = clip.y;
+	clipRight = clip.x + clip.width;
+	clipBottom = clip.y + clip.height;
+}
+
+// Fill a horizontal run, clipped to the clip area
+void MemoryContext::fillSpan(int x0, int x1, int y)
+{
+	if (x0 > x1)
+		std::swap(x0, x1);
+	if (y < clipTop || y >= clipBottom || x1 < clipLeft || x0 >= clipRight)
+		return;
+
+	unsigned int* first = &pixels[y * width + std::max(x0, clipLeft)];
+	unsigned int* last = &pixels[y * width + std::min(x1, clipRight - 1)] + 1;
+
+	if (mode == MODE_XOR)
+	{
+		unsigned int bits = color & RGB_MASK;
+		for (unsigned int* pixel = first; pixel != last; pixel++)
+			*pixel ^= bits;
+	}
+	else
+		std::fill(first, last, color);
+}
+
+// Fill a vertical run, clipped to the clip area
+void MemoryContext::drawVSpan(int x, int y0, int y1)
+{
+	if (y0 > y1)
+		std::swap(y0, y1);
+	if (x < clipLeft || x >= clipRight || y1 < clipTop || y0 >= clipBottom)
+		return;
+
+	unsigned int* pixel = &pixels[std::max(y0, clipTop) * width + x];
+	unsigned int* last = &pixels[std::min(y1, clipBottom - 1) * width + x];
+
+	if (mode == MODE_XOR)
+	{
+		unsigned int bits = color & RGB_MASK;
+		for (; pixel <= last; pixel += width)
+			*pixel ^= bits;
+	}
+	else
+	{
+		for (; pixel <= last; pixel += width)
+			*pixel = color;
+	}
+}
+
+// Set a list of pixels without a virtual call per pixel
+void MemoryContext::setPixels(const Point* points, unsigned int count)
+{
+	for (unsigned int i = 0; i < count; i++)
+		MemoryContext::setPixel(points[i].x, points[i].y);
+}
+
+// Replay the scripted events
+void MemoryContext::runLoop(DrawingBase* drawing)
+{
+	run = true;
+
+	while (run && !events.empty())
+	{
+		Event e = events.front();
+		events.pop_front();
+
+		switch (e.type)
+		{
+			case Event::PAINT:
+				if (e.width > 0 && e.height > 0)
+				{
+					Rect area = {e.x, e.y, e.width, e.height};
+					drawing->paint(this, area);
+				}
+				else
+					drawing->paint(this);
+				break;
+			case Event::KEY_DOWN:
+				drawing->keyDown(this, e.code);
+				break;
+			case Event::KEY_UP:
+				drawing->keyUp(this, e.code);
+				break;
+			case Event::BUTTON_DOWN:
+				drawing->mouseButtonDown(this, e.code, e.x, e.y);
+				break;
+			case Event::BUTTON_UP:
+				drawing->mouseButtonUp(this, e.code, e.x, e.y);
+				break;
+			case Event::MOUSE_MOVE:
+				// like X11Context, only the last of consecutive moves
+				while (!events.empty() && events.front().type == Event::MOUSE_MOVE)
+				{
+					e = events.front();
+					events.pop_front();
+				}
+				drawing->mouseMove(this, e.x, e.y);
+				break;
+		}
+	}
+}
+
+// Add an event to the end of the script replayed by runLoop
+void MemoryContext::queueEvent(const Event& event)
+{
+	events.push_back(event);
+}
+
+int MemoryContext::getWindowWidth()
+{
+	return width;
+}
+
+int MemoryContext::getWindowHeight()
+{
+	return height;
+}
+
+const unsigned int* MemoryContext::getPixels() const
+{
+	return pixels;
+}
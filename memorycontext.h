@@ -0,0 +1,101 @@
+#ifndef MEMORY_CONTEXT
+#define MEMORY_CONTEXT
+/**
+ * This class is an implementation of the GraphicsContext class that
+ * renders into a 32-bit ARGB framebuffer in memory.  It needs no
+ * display, so it can be used for tests, benchmarks and batch rendering.
+ * Instead of waiting on a window system, runLoop replays a script of
+ * events queued with queueEvent.
+ * */
+
+#include <deque>
+#include <vector>
+#include "gcontext.h"	// base class
+
+class MemoryContext : public GraphicsContext
+{
+	public:
+		// An event for runLoop to pass along to the drawing.  code is
+		// the keysym for key events and the button for button events.
+		// A PAINT with a positive width and height repaints only the
+		// area from (x, y), otherwise the whole window.
+		struct Event
+		{
+			enum Type {PAINT, KEY_DOWN, KEY_UP, BUTTON_DOWN, BUTTON_UP, MOUSE_MOVE};
+
+			Type type;
+			unsigned int code;
+			int x;
+			int y;
+			int width;
+			int height;
+		};
+
+		// Creates a sizex by sizey framebuffer filled with bg_color
+		MemoryContext(unsigned int sizex, unsigned int sizey,
+						unsigned int bg_color = GraphicsContext::BLACK);
+
+		// Renders into sizex * sizey pixels owned by the caller, such as
+		// the data of an XImage, instead of its own.  They are cleared
+		// to bg_color and must outlive the context.
+		MemoryContext(unsigned int sizex, unsigned int sizey,
+						unsigned int* framebuffer,
+						unsigned int bg_color = GraphicsContext::BLACK);
+
+		// Destructor
+		virtual ~MemoryContext();
+
+		// Drawing Operations
+		void setMode(drawMode newMode);
+		void setColor(unsigned int color);
+		void setPixel(int x, int y);
+		unsigned int getPixel(int x, int y);
+		void clear();
+		void clearRect(const Rect& area);
+		void setClip(const Rect& area);
+		void clearClip();
+		void fillSpan(int x0, int x1, int y);
+		void drawVSpan(int x, int y0, int y1);
+		void setPixels(const Point* points, unsigned int count);
+
+		// Event loop functions - runLoop returns once the script has
+		// been replayed or endLoop is called.  Consecutive MOUSE_MOVE
+		// events are compressed into the last one.
+		void runLoop(DrawingBase* drawing);
+		void queueEvent(const Event& event);
+
+		// Utility functions
+		int getWindowWidth();
+		int getWindowHeight();
+
+		// The framebuffer, one 0xAARRGGBB value per pixel, row by row.
+		// Alpha is always 0xFF.
+		const unsigned int* getPixels() const;
+
+	private:
+		int width;
+		int height;
+
+		// the framebuffer, which is either storage or the caller's
+		std::vector<unsigned int> storage;
+		unsigned int* pixels;
+
+		// current state, colors already include the alpha byte
+		unsigned int color;
+		unsigned int background;
+		drawMode mode;
+
+		// the clip area, from left/top up to but not including
+		// right/bottom
+		int clipLeft;
+		int clipTop;
+		int clipRight;
+		int clipBottom;
+
+		// copy the clip area from getClip
+		void updateClip();
+
+		std::deque<Event> events;
+};
+
+#endif
@@ -0,0 +1,53 @@
+/**
+ * transform.h - Batch transformation of packed 2D points.  This is the
+ * hot path used when a whole scene is moved from model coordinates to
+ * device coordinates, so it is implemented with SSE2 and AVX2 kernels
+ * that are selected at runtime, with a portable scalar fallback.
+ */
+
+#ifndef TRANSFORM_H
+#define TRANSFORM_H
+
+#include <cstddef>	// for std::size_t
+
+#include "matrix.h"
+
+// Instruction set used by a transform kernel.  The levels are ordered so
+// that a higher level implies support for the lower ones.
+enum class SimdLevel {SCALAR, SSE2, AVX2};
+
+/**
+ * Determines the best instruction set supported by the running CPU.  The
+ * check is only performed once.
+ * Input:
+ *      none
+ * Output:
+ *      SimdLevel - highest supported level
+ **/
+SimdLevel detectSimdLevel();
+
+/**
+ * Applies the affine part of a 4x4 homogeneous transform to packed (x, y)
+ * pairs.  Points are treated as (x, y, 0, 1), so only the x/y rows and the
+ * translation column of m are used.  in and out may be the same array.
+ * Input:
+ *      m - transform to apply
+ *      in - count (x, y) pairs
+ *      out - storage for count (x, y) pairs
+ *      count - number of points
+ * Output:
+ *      none
+ **/
+void transformPoints(const Mat4& m, const double* in, double* out, std::size_t count);
+void transformPoints(const Mat4& m, const float* in, float* out, std::size_t count);
+
+/**
+ * Same as above, but uses the kernel for a specific instruction set rather
+ * than the best available one.  Requests for a level the CPU does not
+ * support fall back to the best supported level.  Intended for testing and
+ * benchmarking the individual kernels.
+ **/
+void transformPoints(const Mat4& m, const double* in, double* out, std::size_t count, SimdLevel level);
+void transformPoints(const Mat4& m, const float* in, float* out, std::size_t count, SimdLevel level);
+
+#endif
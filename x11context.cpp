@@ -6,17 +6,46 @@
 #include <X11/Xlib.h> // Every Xlib program must include this
 #include <X11/Xutil.h> // needed for XGetPixel
 #include <X11/XKBlib.h> // needed for keyboard setup
+#include <sys/ipc.h>
+#include <sys/shm.h>
 #include "x11context.h"
+#include "memorycontext.h"
 #include "drawbase.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <climits>
+#include <utility>
+#include <vector>
+
+// Set by onAttachError if attaching a shared memory segment fails
+static bool attachFailed;
+
+static int onAttachError(Display* display, XErrorEvent* error)
+{
+	attachFailed = true;
+	return 0;
+}
 
 /**
  * The only constructor provided.  Allows size of window and background
  * color be specified.
  * */
 X11Context::X11Context(unsigned int sizex=400,unsigned int sizey=400,
-						unsigned int bg_color=GraphicsContext::BLACK)
+						unsigned int bg_color=GraphicsContext::BLACK,
+						backbufferType backbuffer)
+	: pointCount(0), segmentCount(0), rectangleCount(0), arcCount(0), color(GraphicsContext::WHITE), mode(MODE_NORMAL),
+	  width(sizex), height(sizey)
 {
+	background = bg_color;
+	frameDepth = 0;
+	presentPending = false;
+	framebuffer = NULL;
+	frame = NULL;
+	sharedMemory = false;
+	buffer = None;
+
 	// Open the display
 	display = XOpenDisplay(NULL);
 	
@@ -42,6 +71,24 @@ X11Context::X11Context(unsigned int sizex=400,unsigned int sizey=400,
 	// Default color to white
 	XSetForeground(display, graphics_context, GraphicsContext::WHITE);
 
+	// A second context for clearing the buffer and copying it to the
+	// window, unaffected by the drawing color, mode and clip area.  The
+	// copy would otherwise report NoExpose events for every frame.
+	plain_context = XCreateGC(display, window, 0, NULL);
+	XSetForeground(display, plain_context, background);
+	XSetGraphicsExposures(display, plain_context, False);
+
+	// Drawing goes to an off-screen buffer, which is copied to the
+	// window to present it.  The window's own background would only
+	// flash before the copy, so the server is told not to paint it.
+	XSetWindowBackgroundPixmap(display, window, None);
+	if (backbuffer != BACKBUFFER_IMAGE || !createFrame(sizex, sizey))
+	{
+		buffer = XCreatePixmap(display, window, sizex, sizey,
+								DefaultDepth(display, DefaultScreen(display)));
+		XFillRectangle(display, buffer, plain_context, 0, 0, sizex, sizey);
+	}
+
 	// Wait for MapNotify event
 	for(;;) 
 	{
@@ -51,8 +98,10 @@ X11Context::X11Context(unsigned int sizex=400,unsigned int sizey=400,
 		break;
 	}
 
-	// We also want exposure, mouse, and keyboard events
+	// We also want exposure, mouse, and keyboard events, and resizes
+	// to keep the cached window size current
 	XSelectInput(display, window, ExposureMask|
+								StructureNotifyMask|
 								ButtonPressMask|
 								ButtonReleaseMask|
 								KeyPressMask|
@@ -70,6 +119,11 @@ X11Context::X11Context(unsigned int sizex=400,unsigned int sizey=400,
 // Destructor  - shut down window and connection to server
 X11Context::~X11Context()
 {
+	if (framebuffer)
+		destroyFrame();
+	else
+		XFreePixmap(display, buffer);
+	XFreeGC(display, plain_context);
 	XFreeGC(display, graphics_context);
 	XDestroyWindow(display,window);
 	XCloseDisplay(display);
@@ -78,6 +132,14 @@ X11Context::~X11Context()
 // Set the drawing mode - argument is enumerated
 void X11Context::setMode(drawMode newMode)
 {
+	if (newMode == mode)
+		return;
+
+	submit();
+	mode = newMode;
+	if (framebuffer)
+		framebuffer->setMode(newMode);
+
 	if (newMode == GraphicsContext::MODE_NORMAL)
 	{
 		XSetFunction(display,graphics_context,GXcopy);
@@ -91,22 +153,54 @@ void X11Context::setMode(drawMode newMode)
 // Set drawing color - assume colormap is 24 bit RGB
 void X11Context::setColor(unsigned int color)
 {
+	if (color == this->color)
+		return;
+
+	// queued drawing was done in the old color
+	submit();
+	this->color = color;
+	if (framebuffer)
+		framebuffer->setColor(color);
+
 	// Go ahead and set color here - better performance than setting
 	// on every setPixel 
     XSetForeground(display, graphics_context, color);
 }
 
-// Set a pixel in the current color
+// Set a pixel in the current color.  The point is only queued, and is
+// sent along with the rest of the queue by flush.
 void X11Context::setPixel(int x, int y)
 {
-	XDrawPoint(display, window, graphics_context, x, y);
-	XFlush(display);
+	if (framebuffer)
+	{
+		framebuffer->setPixel(x, y);
+		presentPending = true;
+		return;
+	}
+
+	if (x < 0 || y < 0 || x >= width || y >= height)
+		return;
+
+	if (pointCount == POINT_QUEUE_SIZE)
+		submit();
+
+	points[pointCount].x = x;
+	points[pointCount].y = y;
+	pointCount++;
 }
 
 unsigned int X11Context::getPixel(int x, int y)
 {
+	if (framebuffer)
+		return framebuffer->getPixel(x, y);
+
+	// the pixel may still be waiting in the queue.  It is read from the
+	// buffer, so there is no need to present it first.
+	submit();
+	XFlush(display);
+
 	XImage *image;
-	image = XGetImage (display, window, x, y, 1, 1, AllPlanes, XYPixmap);
+	image = XGetImage (display, buffer, x, y, 1, 1, AllPlanes, XYPixmap);
 	XColor color;
 	color.pixel = XGetPixel (image, 0, 0);
 	XFree (image);
@@ -123,10 +217,309 @@ unsigned int X11Context::getPixel(int x, int y)
 
 void X11Context::clear()
 {
-	XClearWindow(display, window);
+	// anything queued would be cleared anyway
+	pointCount = 0;
+	segmentCount = 0;
+	rectangleCount = 0;
+	arcCount = 0;
+
+	if (framebuffer)
+		framebuffer->clear();
+	else
+		XFillRectangle(display, buffer, plain_context, 0, 0, width, height);
+	presentPending = true;
+}
+
+// Reset an area to the background, ignoring the clip area
+void X11Context::clearRect(const Rect& area)
+{
+	int left = std::max(area.x, 0);
+	int top = std::max(area.y, 0);
+	int right = std::min((long long)area.x + area.width, (long long)width);
+	int bottom = std::min((long long)area.y + area.height, (long long)height);
+	if (left >= right || top >= bottom)
+		return;
+
+	// queued drawing happened before the clear
+	submit();
+	if (framebuffer)
+		framebuffer->clearRect(area);
+	else
+		XFillRectangle(display, buffer, plain_context, left, top, right - left, bottom - top);
+	presentPending = true;
+}
+
+// Limit drawing to an area.  Queued drawing was meant for the old clip
+// area, so it is sent first.
+void X11Context::setClip(const Rect& area)
+{
+	submit();
+	GraphicsContext::setClip(area);
+	applyClip();
+}
+
+// The clip area is cut down to the window, so it is handed on again
+// whenever the window changes size
+void X11Context::applyClip()
+{
+	Rect clip = getClip();
+	if (framebuffer)
+	{
+		framebuffer->setClip(clip);
+		return;
+	}
+
+	XRectangle rectangle;
+	rectangle.x = clip.x;
+	rectangle.y = clip.y;
+	rectangle.width = clip.width;
+	rectangle.height = clip.height;
+	XSetClipRectangles(display, graphics_context, 0, 0, &rectangle, 1, Unsorted);
+}
+
+void X11Context::clearClip()
+{
+	submit();
+	GraphicsContext::clearClip();
+	if (framebuffer)
+		framebuffer->clearClip();
+	else
+		XSetClipMask(display, graphics_context, None);
+}
+
+// Send everything queued and make sure the server has it.  Outside of
+// a frame this also presents the buffer.
+void X11Context::flush()
+{
+	submit();
+	if (frameDepth == 0)
+		present();
 	XFlush(display);
 }
 
+// Frames nest, and only the end of the outermost one presents
+void X11Context::beginFrame()
+{
+	frameDepth++;
+}
+
+void X11Context::endFrame()
+{
+	if (frameDepth > 0)
+		frameDepth--;
+	flush();
+}
+
+// Copy the buffer to the window, if anything was drawn since the last
+// time.  One request, however many pixels were set.
+void X11Context::present()
+{
+	if (!presentPending)
+		return;
+
+	if (!framebuffer)
+		XCopyArea(display, buffer, window, plain_context, 0, 0, width, height, 0, 0);
+	else if (sharedMemory)
+	{
+		// The server reads the pixels straight from the segment, after
+		// the request reaches it.  Wait for that before drawing into
+		// them again.
+		XShmPutImage(display, window, plain_context, frame, 0, 0, 0, 0,
+						width, height, False);
+		XSync(display, False);
+	}
+	else
+		XPutImage(display, window, plain_context, frame, 0, 0, 0, 0, width, height);
+	presentPending = false;
+}
+
+// Hand each queue to Xlib as one request.  Xlib buffers requests itself,
+// so this does not cost a round trip to the server.
+void X11Context::submit()
+{
+	if (pointCount + segmentCount + rectangleCount + arcCount > 0)
+		presentPending = true;
+
+	if (pointCount > 0)
+	{
+		XDrawPoints(display, buffer, graphics_context, points, pointCount,
+					CoordModeOrigin);
+		pointCount = 0;
+	}
+	if (segmentCount > 0)
+	{
+		XDrawSegments(display, buffer, graphics_context, segments, segmentCount);
+		segmentCount = 0;
+	}
+	if (rectangleCount > 0)
+	{
+		XFillRectangles(display, buffer, graphics_context, rectangles, rectangleCount);
+		rectangleCount = 0;
+	}
+	if (arcCount > 0)
+	{
+		XDrawArcs(display, buffer, graphics_context, arcs, arcCount);
+		arcCount = 0;
+	}
+}
+
+// Draw a line in the current color.  Like setPixel, the line is only
+// queued until the next flush.  XSegment only holds 16-bit coordinates,
+// so longer lines are clipped and rasterized by the base class instead.
+void X11Context::drawLine(int x1, int y1, int x2, int y2)
+{
+	if (framebuffer)
+	{
+		framebuffer->drawLine(x1, y1, x2, y2);
+		presentPending = true;
+		return;
+	}
+
+	if ((x1 < 0 && x2 < 0) || (y1 < 0 && y2 < 0) ||
+		(x1 >= width && x2 >= width) || (y1 >= height && y2 >= height))
+		return;
+
+	if (!fitsShort(x1) || !fitsShort(y1) || !fitsShort(x2) || !fitsShort(y2))
+	{
+		GraphicsContext::drawLine(x1, y1, x2, y2);
+		return;
+	}
+
+	if (segmentCount == SEGMENT_QUEUE_SIZE)
+		submit();
+
+	XSegment& segment = segments[segmentCount++];
+	segment.x1 = x1;
+	segment.y1 = y1;
+	segment.x2 = x2;
+	segment.y2 = y2;
+}
+
+// Fill a horizontal run of pixels, queued until the next flush
+void X11Context::fillSpan(int x0, int x1, int y)
+{
+	if (framebuffer)
+	{
+		framebuffer->fillSpan(x0, x1, y);
+		presentPending = true;
+		return;
+	}
+
+	if (x0 > x1)
+		std::swap(x0, x1);
+	if (y < 0 || y >= height || x1 < 0 || x0 >= width)
+		return;
+	x0 = std::max(x0, 0);
+	x1 = std::min(x1, width - 1);
+
+	if (rectangleCount == RECTANGLE_QUEUE_SIZE)
+		submit();
+
+	XRectangle& rectangle = rectangles[rectangleCount++];
+	rectangle.x = x0;
+	rectangle.y = y;
+	rectangle.width = x1 - x0 + 1;
+	rectangle.height = 1;
+}
+
+// Fill a vertical run of pixels, queued until the next flush
+void X11Context::drawVSpan(int x, int y0, int y1)
+{
+	if (framebuffer)
+	{
+		framebuffer->drawVSpan(x, y0, y1);
+		presentPending = true;
+		return;
+	}
+
+	if (y0 > y1)
+		std::swap(y0, y1);
+	if (x < 0 || x >= width || y1 < 0 || y0 >= height)
+		return;
+	y0 = std::max(y0, 0);
+	y1 = std::min(y1, height - 1);
+
+	if (rectangleCount == RECTANGLE_QUEUE_SIZE)
+		submit();
+
+	XRectangle& rectangle = rectangles[rectangleCount++];
+	rectangle.x = x;
+	rectangle.y = y0;
+	rectangle.width = 1;
+	rectangle.height = y1 - y0 + 1;
+}
+
+// Add a list of pixels to the point queue
+void X11Context::setPixels(const Point* points, unsigned int count)
+{
+	if (framebuffer)
+	{
+		framebuffer->setPixels(points, count);
+		presentPending = true;
+		return;
+	}
+
+	for (unsigned int i = 0; i < count; i++)
+	{
+		if (points[i].x < 0 || points[i].y < 0 ||
+			points[i].x >= width || points[i].y >= height)
+			continue;
+
+		if (pointCount == POINT_QUEUE_SIZE)
+			submit();
+
+		this->points[pointCount].x = points[i].x;
+		this->points[pointCount].y = points[i].y;
+		pointCount++;
+	}
+}
+
+// Fill a triangle in the current color
+void X11Context::fillTriangle(int x0, int y0, int x1, int y1, int x2, int y2)
+{
+	if (framebuffer)
+	{
+		framebuffer->fillTriangle(x0, y0, x1, y1, x2, y2);
+		presentPending = true;
+		return;
+	}
+
+	GraphicsContext::fillTriangle(x0, y0, x1, y1, x2, y2);
+}
+
+// Draw a circle in the current color, queued until the next flush.
+// Circles that do not fit an XArc are drawn by the base class.
+void X11Context::drawCircle(int x, int y, unsigned int radius)
+{
+	if (framebuffer)
+	{
+		framebuffer->drawCircle(x, y, radius);
+		presentPending = true;
+		return;
+	}
+
+	long long r = radius;
+	if (x + r < 0 || y + r < 0 || x - r >= width || y - r >= height)
+		return;
+
+	if (!fitsShort(x - r) || !fitsShort(y - r) || 2 * r > USHRT_MAX)
+	{
+		GraphicsContext::drawCircle(x, y, radius);
+		return;
+	}
+
+	if (arcCount == ARC_QUEUE_SIZE)
+		submit();
+
+	XArc& arc = arcs[arcCount++];
+	arc.x = x - radius;
+	arc.y = y - radius;
+	arc.width = radius * 2;
+	arc.height = radius * 2;
+	arc.angle1 = 0;
+	arc.angle2 = 360 * 64;
+}
+
  
 
 // Run event loop
@@ -139,9 +532,40 @@ void X11Context::runLoop(DrawingBase* drawing)
 		XEvent e;
 		XNextEvent(display, &e);
 
-		// Exposure event - lets not worry about region
+		// Exposure event - an uncover arrives as a burst of rectangles,
+		// with count saying how many more follow.  They are merged into
+		// one area, along with any other Expose directly behind them,
+		// and painted once.  The queue is only read from its head, so an
+		// Expose that follows a ConfigureNotify is painted after the
+		// resize rather than clipped to the old size.  While count says
+		// the burst goes on, XPeekEvent waits for the rest of it.
 		if (e.type == Expose)
-			drawing->paint(this);
+		{
+			int left = e.xexpose.x;
+			int top = e.xexpose.y;
+			int right = e.xexpose.x + e.xexpose.width;
+			int bottom = e.xexpose.y + e.xexpose.height;
+
+			XEvent next;
+			while (e.xexpose.count > 0 || XEventsQueued(display, QueuedAfterReading) > 0)
+			{
+				XPeekEvent(display, &next);
+				if (next.type != Expose || next.xexpose.window != e.xexpose.window)
+					break;
+				XNextEvent(display, &e);
+
+				left = std::min(left, e.xexpose.x);
+				top = std::min(top, e.xexpose.y);
+				right = std::max(right, e.xexpose.x + e.xexpose.width);
+				bottom = std::max(bottom, e.xexpose.y + e.xexpose.height);
+			}
+
+			// the exposed part of the window lost its contents, so the
+			// buffer is presented even if the paint leaves it unchanged
+			GraphicsContext::Rect area = {left, top, right - left, bottom - top};
+			drawing->paint(this, area);
+			presentPending = true;
+		}
 
 		// Key Down
 		else if (e.type == KeyPress)
@@ -170,44 +594,226 @@ void X11Context::runLoop(DrawingBase* drawing)
 			e.xbutton.x,
 			e.xbutton.y);
 			
-		// Mouse Move	
+		// Mouse Move - when the pointer has already moved on, only the
+		// latest of a run of queued motion events is handed over.  Only
+		// events directly behind this one are skipped, so button and
+		// key events stay in order with the motion around them.
 		else if (e.type == MotionNotify)
+		{
+			XEvent next;
+			while (XEventsQueued(display, QueuedAfterReading) > 0)
+			{
+				XPeekEvent(display, &next);
+				if (next.type != MotionNotify || next.xmotion.window != e.xmotion.window)
+					break;
+				XNextEvent(display, &e);
+			}
+
 			drawing->mouseMove(this,
 			e.xmotion.x,
 			e.xmotion.y);
+		}
 
 		// This will respond to the WM_DELETE_WINDOW from the
 		// window manager.
 		else if (e.type == ClientMessage)
 		break;
+
+		// Keep the cached size current for clipping
+		else if (e.type == ConfigureNotify)
+			resize(e.xconfigure.width, e.xconfigure.height);
+
+		// show whatever the event handler drew
+		flush();
 	}
 }
 
 
-int X11Context::getWindowWidth()
+// Follow a change in window size with a buffer of the same size.  What
+// was drawn is kept, and newly uncovered parts start out as background
+// until the Expose that follows repaints them.
+void X11Context::resize(int newWidth, int newHeight)
+{
+	if (newWidth == width && newHeight == height)
+		return;
+
+	submit();
+	if (framebuffer)
+	{
+		std::vector<unsigned int> old(framebuffer->getPixels(),
+										framebuffer->getPixels() + width * height);
+		destroyFrame();
+
+		// the visual has not changed, so this can only fail if memory
+		// runs out
+		if (!createFrame(newWidth, newHeight))
+		{
+			std::cerr << "X11Context: cannot allocate a "
+					<< newWidth << "x" << newHeight << " image" << std::endl;
+			std::abort();
+		}
+
+		unsigned int* pixels = reinterpret_cast<unsigned int*>(frame->data);
+		int rowWidth = std::min(width, newWidth);
+		for (int y = 0; y < std::min(height, newHeight); y++)
+			std::memcpy(&pixels[y * newWidth], &old[y * width], rowWidth * sizeof(unsigned int));
+
+		framebuffer->setColor(color);
+		framebuffer->setMode(mode);
+	}
+	else
+	{
+		Pixmap resized = XCreatePixmap(display, window, newWidth, newHeight,
+								DefaultDepth(display, DefaultScreen(display)));
+		XFillRectangle(display, resized, plain_context, 0, 0, newWidth, newHeight);
+		XCopyArea(display, buffer, resized, plain_context, 0, 0,
+					std::min(width, newWidth), std::min(height, newHeight), 0, 0);
+		XFreePixmap(display, buffer);
+		buffer = resized;
+	}
+
+	width = newWidth;
+	height = newHeight;
+	presentPending = true;
+
+	// the clip area was cut down to the old size, so it may have grown,
+	// and a new framebuffer starts out without one
+	if (hasClip())
+		applyClip();
+}
+
+// Set up a client-side image the size of the window, and a MemoryContext
+// drawing into it.  Its pixels are used as they are, so the visual must
+// take 32-bit 0x00RRGGBB pixels in the client's byte order.
+bool X11Context::createFrame(int frameWidth, int frameHeight)
 {
-	XWindowAttributes window_attributes;
-	XGetWindowAttributes(display,window, &window_attributes);
-	return window_attributes.width;
+	int screen = DefaultScreen(display);
+	Visual* visual = DefaultVisual(display, screen);
+	int depth = DefaultDepth(display, screen);
+	if (depth < 24 || visual->red_mask != 0xFF0000 ||
+		visual->green_mask != 0x00FF00 || visual->blue_mask != 0x0000FF)
+		return false;
+
+	const unsigned int probe = 1;
+	int byteOrder = *reinterpret_cast<const char*>(&probe) ? LSBFirst : MSBFirst;
+
+	frame = NULL;
+	sharedMemory = false;
+	if (XShmQueryExtension(display))
+		frame = createSharedImage(visual, depth, frameWidth, frameHeight);
+
+	if (frame && (frame->bits_per_pixel != 32 || frame->byte_order != byteOrder ||
+		frame->bytes_per_line != frameWidth * 4))
+		destroyFrame();
+
+	if (!frame)
+	{
+		// XPutImage converts from the client's byte order if need be
+		char* data = static_cast<char*>(std::malloc(frameWidth * frameHeight * 4));
+		if (!data)
+			return false;
+		frame = XCreateImage(display, visual, depth, ZPixmap, 0, data,
+								frameWidth, frameHeight, 32, frameWidth * 4);
+		if (!frame)
+		{
+			std::free(data);
+			return false;
+		}
+		frame->byte_order = byteOrder;
+
+		if (frame->bits_per_pixel != 32)
+		{
+			destroyFrame();
+			return false;
+		}
+	}
+
+	framebuffer = new MemoryContext(frameWidth, frameHeight,
+						reinterpret_cast<unsigned int*>(frame->data), background);
+	return true;
 }
 
-int X11Context::getWindowHeight()
+// Create an image in a shared memory segment and attach the server to
+// it.  Returns NULL if any step fails - attaching fails with an X error
+// when the server is on another machine.
+XImage* X11Context::createSharedImage(Visual* visual, int depth, int frameWidth, int frameHeight)
 {
-	XWindowAttributes window_attributes;
-	XGetWindowAttributes(display,window, &window_attributes);
-	return window_attributes.height;
+	XImage* image = XShmCreateImage(display, visual, depth, ZPixmap, NULL,
+									&shmInfo, frameWidth, frameHeight);
+	if (!image)
+		return NULL;
+
+	shmInfo.shmid = shmget(IPC_PRIVATE, image->bytes_per_line * image->height,
+							IPC_CREAT | 0600);
+	if (shmInfo.shmid < 0)
+	{
+		XDestroyImage(image);
+		return NULL;
+	}
+
+	shmInfo.shmaddr = static_cast<char*>(shmat(shmInfo.shmid, NULL, 0));
+	if (shmInfo.shmaddr == reinterpret_cast<char*>(-1))
+	{
+		shmctl(shmInfo.shmid, IPC_RMID, NULL);
+		XDestroyImage(image);
+		return NULL;
+	}
+	shmInfo.readOnly = False;
+
+	attachFailed = false;
+	XErrorHandler previous = XSetErrorHandler(onAttachError);
+	XShmAttach(display, &shmInfo);
+	XSync(display, False);
+	XSetErrorHandler(previous);
+
+	// the segment goes away once both sides have detached
+	shmctl(shmInfo.shmid, IPC_RMID, NULL);
+
+	if (attachFailed)
+	{
+		shmdt(shmInfo.shmaddr);
+		XDestroyImage(image);
+		return NULL;
+	}
+
+	image->data = shmInfo.shmaddr;
+	sharedMemory = true;
+	return image;
 }
 
-void X11Context::draw_line(int x1, int y1, int x2, int y2)
+// Release the image, its memory and the MemoryContext drawing into it
+void X11Context::destroyFrame()
 {
-	XDrawLine(display, window, graphics_context, x1, y1, x2, y2);		
-	XFlush(display);
+	delete framebuffer;
+	framebuffer = NULL;
+
+	if (sharedMemory)
+	{
+		XShmDetach(display, &shmInfo);
+		shmdt(shmInfo.shmaddr);
+
+		// the data was not allocated by Xlib, so it must not free it
+		frame->data = NULL;
+		sharedMemory = false;
+	}
+	XDestroyImage(frame);
+	frame = NULL;
 }
 
-void X11Context::draw_circle(int x, int y, int radius)
+// The size is cached, since asking the server costs a round trip and
+// every clipped line needs it
+int X11Context::getWindowWidth()
 {
-	XDrawArc(display, window, graphics_context, x-radius,
-				 y-radius, radius*2, radius*2, 0, 360*64);
-	XFlush(display);
+	return width;
 }
 
+int X11Context::getWindowHeight()
+{
+	return height;
+}
+
+// Whether a coordinate fits in the 16-bit fields of Xlib's structures
+bool X11Context::fitsShort(long long value)
+{
+	return value >= SHRT_MIN && value <= SHRT_MAX;
+}
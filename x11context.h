@@ -6,13 +6,25 @@
  * */    
  
 #include <X11/Xlib.h>   // Every Xlib program must include this
+#include <X11/extensions/XShm.h>
 #include "gcontext.h"	// base class
 
+class MemoryContext;
+
 class X11Context : public GraphicsContext
 {
 	public:
+		// Where drawing goes before it is presented.  BACKBUFFER_PIXMAP
+		// has the server rasterize into a Pixmap.  BACKBUFFER_IMAGE
+		// rasterizes on the client into an XImage, shared with the
+		// server through MIT-SHM where possible and sent with XPutImage
+		// where not (e.g. a remote display).  If the visual is not
+		// 32-bit xRGB the image falls back to the Pixmap.
+		enum backbufferType {BACKBUFFER_PIXMAP, BACKBUFFER_IMAGE};
+
 		// Default Constructor
-		X11Context(unsigned int sizex,unsigned int sizey,unsigned int bg_color);
+		X11Context(unsigned int sizex,unsigned int sizey,unsigned int bg_color,
+					backbufferType backbuffer = BACKBUFFER_PIXMAP);
 
 		// Destructor
 		virtual ~X11Context();
@@ -21,17 +33,40 @@ class X11Context : public GraphicsContext
 		void setMode(drawMode newMode);
 		void setColor(unsigned int color);
 		void setPixel(int x, int y);
-		void draw_line(int x1, int y1, int x2, int y2);
-		void draw_circle(int x, int y, int radius);
 		unsigned int getPixel(int x, int y);
 		void clear();
+		void clearRect(const Rect& area);
+		void flush();
+
+		// Everything is drawn into an off-screen buffer, which flush
+		// copies to the window outside of a frame and endFrame copies
+		// at the end of the outermost frame.
+		void beginFrame();
+		void endFrame();
+
+		// The clip area is handed to the server as the clip rectangle
+		// of the graphics context.
+		void setClip(const Rect& area);
+		void clearClip();
 
 		/*
-		 * These are not currently overridden, but could be as XLib
-		 * has much more efficient implementations available.
+		 * XLib has much more efficient implementations of these, so
+		 * lines and circles are queued like points and rasterized by
+		 * the server.
 		 */
-		//void drawLine(int x1, int y1, int x2, int y2);
-		//void drawCircle(int x, int y, int radius);
+		void drawLine(int x1, int y1, int x2, int y2);
+		void drawCircle(int x, int y, unsigned int radius);
+
+		// Spans are filled as 1 pixel high or wide rectangles, and
+		// lists of pixels go straight into the point queue.  Anything
+		// outside the window is dropped before it is queued.
+		void fillSpan(int x0, int x1, int y);
+		void drawVSpan(int x, int y0, int y1);
+		void setPixels(const Point* points, unsigned int count);
+
+		// Handed whole to the client-side image, if there is one, and
+		// filled span by span otherwise
+		void fillTriangle(int x0, int y0, int x1, int y1, int x2, int y2);
 
 
 		// Event looop functions
@@ -50,6 +85,76 @@ class X11Context : public GraphicsContext
 		Window window;
 		GC graphics_context;
 
+		// The off-screen buffer everything is drawn into, and a context
+		// with no clip area and graphics exposures off for clearing and
+		// presenting it
+		Pixmap buffer;
+		GC plain_context;
+		unsigned int background;
+
+		// how many frames have begun and not ended, and whether the
+		// buffer changed since it was last presented
+		int frameDepth;
+		bool presentPending;
+
+		// copy the buffer to the window
+		void present();
+
+		// replace the buffer with one of a new size
+		void resize(int newWidth, int newHeight);
+
+		// give the clip area, cut down to the window, to the buffer
+		// being drawn into
+		void applyClip();
+
+		// With BACKBUFFER_IMAGE the drawing is done by a MemoryContext
+		// rendering into the pixels of frame, and buffer is None.
+		// Otherwise framebuffer and frame are NULL.
+		MemoryContext* framebuffer;
+		XImage* frame;
+		XShmSegmentInfo shmInfo;
+		bool sharedMemory;
+
+		// create or destroy frame and framebuffer, createFrame returns
+		// false if the visual does not suit a client-side image
+		bool createFrame(int frameWidth, int frameHeight);
+		XImage* createSharedImage(Visual* visual, int depth, int frameWidth, int frameHeight);
+		void destroyFrame();
+
+		// Points, lines and circles drawn since the last flush.  They
+		// all share the color and mode currently set on
+		// graphics_context, so the queues are submitted before either
+		// changes.  Within one color and mode the order they reach the
+		// window in does not matter: copy mode sets the same color
+		// either way, and xor-ing the same color is commutative.
+		static const int POINT_QUEUE_SIZE = 4096;
+		XPoint points[POINT_QUEUE_SIZE];
+		int pointCount;
+
+		static const int SEGMENT_QUEUE_SIZE = 4096;
+		XSegment segments[SEGMENT_QUEUE_SIZE];
+		int segmentCount;
+
+		static const int RECTANGLE_QUEUE_SIZE = 4096;
+		XRectangle rectangles[RECTANGLE_QUEUE_SIZE];
+		int rectangleCount;
+
+		static const int ARC_QUEUE_SIZE = 1024;
+		XArc arcs[ARC_QUEUE_SIZE];
+		int arcCount;
+
+		// send the queues without flushing the connection
+		void submit();
+
+		unsigned int color;
+		drawMode mode;
+
+		// window size, updated on ConfigureNotify
+		int width;
+		int height;
+
+		static bool fitsShort(long long value);
+
 };
 
 #endif